@@ -220,7 +220,11 @@ cloud_ep_session_event_handler(const oc_endpoint_t *endpoint,
     OC_DBG("[CM] cloud_ep_session_event_handler ep_state: %d\n", (int)state);
     ctx->cloud_ep_state = state;
     if (ctx->cloud_ep_state == OC_SESSION_DISCONNECTED && ctx->cloud_manager) {
-      cloud_manager_restart(ctx);
+      if (!(ctx->store.status & OC_CLOUD_LOGGED_IN) ||
+          oc_string_len(ctx->store.access_token) == 0 ||
+          !cloud_manager_fast_reconnect(ctx)) {
+        cloud_manager_restart(ctx);
+      }
     }
   }
 }
@@ -97,9 +97,11 @@ bool cloud_access_refresh_access_token(oc_endpoint_t *endpoint, const char *uid,
 
 void cloud_rd_manager_status_changed(oc_cloud_context_t *ctx);
 void cloud_rd_deinit(oc_cloud_context_t *ctx);
+void cloud_rd_flush(oc_cloud_context_t *ctx);
 
 void cloud_manager_start(oc_cloud_context_t *ctx);
 void cloud_manager_stop(oc_cloud_context_t *ctx);
+bool cloud_manager_fast_reconnect(oc_cloud_context_t *ctx);
 
 void oc_create_cloudconf_resource(size_t device);
 
@@ -24,6 +24,7 @@
 #include "oc_cloud_internal.h"
 #include "oc_endpoint.h"
 #include "port/oc_log.h"
+#include "port/oc_random.h"
 #include "rd_client.h"
 #include "util/oc_list.h"
 #include "util/oc_memb.h"
@@ -42,6 +43,22 @@
 #define PING_DELAY_ON_TIMEOUT 3
 #define MAX_RETRY_COUNT (5)
 
+#ifndef OC_CLOUD_RECONNECT_BASE_DELAY_MS
+#define OC_CLOUD_RECONNECT_BASE_DELAY_MS (3000)
+#endif /* !OC_CLOUD_RECONNECT_BASE_DELAY_MS */
+
+#ifndef OC_CLOUD_RECONNECT_MAX_DELAY_MS
+#define OC_CLOUD_RECONNECT_MAX_DELAY_MS (300000)
+#endif /* !OC_CLOUD_RECONNECT_MAX_DELAY_MS */
+
+/* Keepalive delays are spread by this percentage around their nominal value
+ * so that devices which reconnected together do not keep pinging in step.
+ */
+#define KEEPALIVE_JITTER_PERCENT (25)
+#define MAX_PING_TIMEOUT (10)
+/* Smallest change of the smoothed RTT reported through the status callback */
+#define MIN_RTT_REPORT_DELTA_MS (10)
+
 struct oc_memb rep_objects_pool = { sizeof(oc_rep_t), 0, 0, 0, 0 };
 
 static void cloud_start_process(oc_cloud_context_t *ctx);
@@ -60,10 +77,111 @@ callback_handler(void *data)
   cloud_manager_cb(ctx);
   ctx->store.status &=
     ~(OC_CLOUD_FAILURE | OC_CLOUD_LOGGED_OUT | OC_CLOUD_REFRESHED_TOKEN |
-      OC_CLOUD_TOKEN_EXPIRY | OC_CLOUD_DEREGISTERED);
+      OC_CLOUD_TOKEN_EXPIRY | OC_CLOUD_DEREGISTERED | OC_CLOUD_TIMING_UPDATED);
   return OC_EVENT_DONE;
 }
 
+static uint32_t
+random_ms(uint32_t max_ms)
+{
+  if (max_ms == 0) {
+    return 0;
+  }
+  return (uint32_t)(oc_random_value() % (max_ms + 1));
+}
+
+static oc_clock_time_t
+ms_to_ticks(uint32_t ms)
+{
+  return (oc_clock_time_t)ms * OC_CLOCK_SECOND / 1000;
+}
+
+/* Exponential backoff with full jitter: a uniformly random delay up to
+ * base * 2^attempts, capped at OC_CLOUD_RECONNECT_MAX_DELAY_MS.
+ */
+static oc_clock_time_t
+reconnect_delay(oc_cloud_context_t *ctx)
+{
+  uint32_t cap = OC_CLOUD_RECONNECT_BASE_DELAY_MS;
+  uint16_t i;
+  for (i = 0; i < ctx->timing.reconnects && cap < OC_CLOUD_RECONNECT_MAX_DELAY_MS;
+       i++) {
+    cap *= 2;
+  }
+  if (cap > OC_CLOUD_RECONNECT_MAX_DELAY_MS) {
+    cap = OC_CLOUD_RECONNECT_MAX_DELAY_MS;
+  }
+  if (ctx->timing.reconnects < UINT16_MAX) {
+    ctx->timing.reconnects++;
+  }
+  ctx->timing.reconnect_delay_ms = random_ms(cap);
+  return ms_to_ticks(ctx->timing.reconnect_delay_ms);
+}
+
+static void
+schedule_ping(oc_cloud_context_t *ctx, uint16_t delay_seconds)
+{
+  uint32_t delay_ms = (uint32_t)delay_seconds * 1000;
+  uint32_t spread = delay_ms / 100 * KEEPALIVE_JITTER_PERCENT;
+  delay_ms = delay_ms - spread + random_ms(2 * spread);
+  /* Never probe again before the previous ping could have come back */
+  if (delay_ms < 2 * ctx->timing.srtt_ms) {
+    delay_ms = 2 * ctx->timing.srtt_ms;
+  }
+  ctx->timing.keepalive_ms = delay_ms;
+  oc_remove_delayed_callback(ctx, send_ping);
+  oc_ri_add_timed_event_callback_ticks(ctx, send_ping, ms_to_ticks(delay_ms));
+}
+
+/* Allows four smoothed round trips for the pong, like a TCP retransmission
+ * timer would.
+ */
+static uint16_t
+ping_timeout(oc_cloud_context_t *ctx)
+{
+  uint32_t timeout = (4 * ctx->timing.srtt_ms + 999) / 1000;
+  if (timeout < 1) {
+    timeout = 1;
+  } else if (timeout > MAX_PING_TIMEOUT) {
+    timeout = MAX_PING_TIMEOUT;
+  }
+  return (uint16_t)timeout;
+}
+
+/* Refreshes somewhere between 75% and 90% of the token lifetime, so devices
+ * that signed in together spread their refreshes out.
+ */
+static void
+schedule_refresh_token(oc_cloud_context_t *ctx)
+{
+  uint32_t lifetime_ms = (uint32_t)ctx->expires_in * 1000;
+  uint32_t delay_ms =
+    lifetime_ms / 100 * 75 + random_ms(lifetime_ms / 100 * 15);
+  ctx->timing.token_refresh_s = delay_ms / 1000;
+  oc_remove_delayed_callback(ctx, refresh_token);
+  oc_ri_add_timed_event_callback_ticks(ctx, refresh_token,
+                                       ms_to_ticks(delay_ms));
+}
+
+static void
+update_rtt(oc_cloud_context_t *ctx)
+{
+  oc_clock_time_t elapsed = oc_clock_time() - ctx->ping_sent;
+  uint32_t rtt = (uint32_t)(elapsed * 1000 / OC_CLOCK_SECOND);
+  uint32_t srtt = ctx->timing.srtt_ms;
+  srtt = srtt ? (7 * srtt + rtt) / 8 : rtt;
+  ctx->timing.rtt_ms = rtt;
+  ctx->timing.srtt_ms = srtt;
+
+  uint32_t reported = ctx->reported_srtt_ms;
+  uint32_t delta = srtt > reported ? srtt - reported : reported - srtt;
+  if (delta >= MIN_RTT_REPORT_DELTA_MS && delta * 4 > reported) {
+    ctx->reported_srtt_ms = srtt;
+    ctx->store.status |= OC_CLOUD_TIMING_UPDATED;
+    oc_set_delayed_callback(ctx, callback_handler, 0);
+  }
+}
+
 void
 cloud_manager_start(oc_cloud_context_t *ctx)
 {
@@ -86,11 +204,33 @@ cloud_manager_stop(oc_cloud_context_t *ctx)
 static void
 reconnect(oc_cloud_context_t *ctx)
 {
+  /* The session is torn down because it stopped working, so it must not be
+   * resumed by a fast reconnect.
+   */
+  ctx->store.status &= ~OC_CLOUD_LOGGED_IN;
   oc_set_delayed_callback(ctx, callback_handler, 0);
   oc_remove_delayed_callback(ctx, refresh_token);
   cloud_reconnect(ctx);
 }
 
+bool
+cloud_manager_fast_reconnect(oc_cloud_context_t *ctx)
+{
+  OC_DBG("[CM] cloud_manager_fast_reconnect(%d)\n", ctx->fast_reconnect_count);
+  /* The session went down with the connection, so nothing is sent as signed
+   * in until the cloud accepts the sign-in again.
+   */
+  ctx->store.status &= ~OC_CLOUD_LOGGED_IN;
+  if (ctx->fast_reconnect_count >= MAX_RETRY_COUNT) {
+    return false;
+  }
+  ctx->fast_reconnect_count++;
+  cloud_manager_stop(ctx);
+  ctx->retry_count = 0;
+  oc_ri_add_timed_event_callback_ticks(ctx, cloud_login, reconnect_delay(ctx));
+  return true;
+}
+
 static bool
 is_refresh_token_retry_over(oc_cloud_context_t *ctx)
 {
@@ -115,15 +255,17 @@ static void
 cloud_start_process(oc_cloud_context_t *ctx)
 {
   ctx->retry_count = 0;
+  ctx->fast_reconnect_count = 0;
 
+  oc_clock_time_t delay = reconnect_delay(ctx);
   if (ctx->store.status == OC_CLOUD_INITIALIZED) {
-    oc_set_delayed_callback(ctx, cloud_register, session_timeout[0]);
+    oc_ri_add_timed_event_callback_ticks(ctx, cloud_register, delay);
   } else {
     if (oc_string(ctx->store.refresh_token) &&
         oc_string_len(ctx->store.refresh_token) > 0) {
-      oc_set_delayed_callback(ctx, refresh_token, session_timeout[0]);
+      oc_ri_add_timed_event_callback_ticks(ctx, refresh_token, delay);
     } else {
-      oc_set_delayed_callback(ctx, cloud_login, session_timeout[0]);
+      oc_ri_add_timed_event_callback_ticks(ctx, cloud_login, delay);
     }
   }
   _oc_signal_event_loop();
@@ -331,9 +473,12 @@ cloud_login_handler(oc_client_response_t *data)
   if (ret == 0) {
     oc_remove_delayed_callback(ctx, cloud_login);
     oc_set_delayed_callback(ctx, callback_handler, 0);
-    oc_set_delayed_callback(ctx, send_ping, PING_DELAY);
+    ctx->timing.reconnects = 0;
+    schedule_ping(ctx, PING_DELAY);
     if (ctx->store.status & OC_CLOUD_TOKEN_EXPIRY) {
-      oc_set_delayed_callback(ctx, refresh_token, ctx->expires_in);
+      schedule_refresh_token(ctx);
+    } else {
+      ctx->timing.token_refresh_s = 0;
     }
   } else {
     oc_remove_delayed_callback(ctx, cloud_login);
@@ -366,6 +511,14 @@ cloud_login(void *data)
                              oc_string(ctx->store.access_token), ctx->device,
                              cloud_login_handler, ctx)) {
         cannotConnect = false;
+        if (ctx->fast_reconnect_count > 0) {
+          /* Signing in again on a new connection: queue pending RD updates
+           * right behind the sign-in request on the same stream.
+           */
+          cloud_rd_flush(ctx);
+        } else {
+          ctx->rd_flush_pipelined = false;
+        }
       }
       if (cannotConnect) {
         cloud_set_last_error(ctx, CLOUD_ERROR_CONNECT);
@@ -516,14 +669,17 @@ send_ping_handler(oc_client_response_t *data)
   if (data->code == OC_PING_TIMEOUT)
     goto error;
 
-  oc_remove_delayed_callback(ctx, send_ping);
+  /* The connection has carried traffic since the last sign-in, so the next
+   * drop may take the fast path again.
+   */
   ctx->retry_count = 0;
-  oc_set_delayed_callback(ctx, send_ping, PING_DELAY);
+  ctx->fast_reconnect_count = 0;
+  update_rtt(ctx);
+  schedule_ping(ctx, PING_DELAY);
   return;
 
 error:
-  oc_remove_delayed_callback(ctx, send_ping);
-  oc_set_delayed_callback(ctx, send_ping, PING_DELAY_ON_TIMEOUT);
+  schedule_ping(ctx, PING_DELAY_ON_TIMEOUT);
   if (data->code == OC_PING_TIMEOUT) {
     cloud_set_last_error(ctx, CLOUD_ERROR_CONNECT);
   }
@@ -541,7 +697,9 @@ send_ping(void *data)
   OC_DBG("[CM] try send ping(%d)\n", ctx->retry_count);
   ctx->retry_count++;
   if (!is_retry_over(ctx)) {
-    if (!oc_send_ping(false, ctx->cloud_ep, 1, send_ping_handler, ctx)) {
+    ctx->ping_sent = oc_clock_time();
+    if (!oc_send_ping(false, ctx->cloud_ep, ping_timeout(ctx),
+                      send_ping_handler, ctx)) {
       cloud_set_last_error(ctx, CLOUD_ERROR_CONNECT);
     }
   }
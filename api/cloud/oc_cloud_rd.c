@@ -29,14 +29,128 @@
 #define OC_RSRVD_HREF "href"
 #define OC_RSRVD_INSTANCEID "ins"
 
-static oc_link_t *
-rd_link_find(oc_link_t *head, oc_resource_t *res)
+#ifndef OC_CLOUD_RD_PUBLISH_DELAY_MS
+#define OC_CLOUD_RD_PUBLISH_DELAY_MS (100)
+#endif /* !OC_CLOUD_RD_PUBLISH_DELAY_MS */
+
+#ifndef OC_CLOUD_RD_LINK_BUCKETS
+#ifdef OC_DYNAMIC_ALLOCATION
+#define OC_CLOUD_RD_LINK_BUCKETS (64)
+#else /* OC_DYNAMIC_ALLOCATION */
+#define OC_CLOUD_RD_LINK_BUCKETS (OC_MAX_APP_RESOURCES + 2)
+#endif /* !OC_DYNAMIC_ALLOCATION */
+#endif /* !OC_CLOUD_RD_LINK_BUCKETS */
+
+/* Publish state of a link in rd_publish_resources or rd_published_resources,
+ * hashed by its target resource, and by its device and href
+ */
+typedef struct rd_link_entry_t
+{
+  struct rd_link_entry_t *next_by_resource;
+  struct rd_link_entry_t *next_by_href;
+  oc_link_t *link;
+  bool published;
+} rd_link_entry_t;
+
+static rd_link_entry_t *rd_links_by_resource[OC_CLOUD_RD_LINK_BUCKETS];
+static rd_link_entry_t *rd_links_by_href[OC_CLOUD_RD_LINK_BUCKETS];
+OC_MEMB(rd_link_entries_s, rd_link_entry_t,
+        OC_MAX_NUM_DEVICES *(OC_MAX_APP_RESOURCES + 2));
+
+static size_t
+rd_resource_bucket(const oc_resource_t *resource)
 {
-  oc_link_t *iter = head;
-  while (iter != NULL && iter->resource != res) {
-    iter = iter->next;
+  return (size_t)(((uintptr_t)resource >> 3) % OC_CLOUD_RD_LINK_BUCKETS);
+}
+
+static size_t
+rd_href_bucket(size_t device, const char *href, size_t href_size)
+{
+  uint32_t hash = 5381;
+  size_t i;
+  for (i = 0; i < href_size; i++) {
+    hash = ((hash << 5) + hash) + (uint8_t)href[i];
   }
-  return iter;
+  hash ^= (uint32_t)device;
+  return (size_t)(hash % OC_CLOUD_RD_LINK_BUCKETS);
+}
+
+static rd_link_entry_t *
+rd_link_find(oc_resource_t *res)
+{
+  rd_link_entry_t *entry = rd_links_by_resource[rd_resource_bucket(res)];
+  while (entry != NULL && entry->link->resource != res) {
+    entry = entry->next_by_resource;
+  }
+  return entry;
+}
+
+static rd_link_entry_t *
+rd_link_find_by_href(size_t device, const char *href, size_t href_size)
+{
+  rd_link_entry_t *entry =
+    rd_links_by_href[rd_href_bucket(device, href, href_size)];
+  while (entry != NULL) {
+    oc_resource_t *res = entry->link->resource;
+    if (res->device == device && oc_string_len(res->uri) == href_size &&
+        memcmp(oc_string(res->uri), href, href_size) == 0) {
+      return entry;
+    }
+    entry = entry->next_by_href;
+  }
+  return NULL;
+}
+
+static bool
+rd_link_index(oc_link_t *link)
+{
+  rd_link_entry_t *entry = oc_memb_alloc(&rd_link_entries_s);
+  if (!entry) {
+    OC_WRN("[CRD] insufficient memory to track link");
+    return false;
+  }
+  oc_resource_t *res = link->resource;
+  entry->link = link;
+  entry->published = false;
+  size_t b = rd_resource_bucket(res);
+  entry->next_by_resource = rd_links_by_resource[b];
+  rd_links_by_resource[b] = entry;
+  b = rd_href_bucket(res->device, oc_string(res->uri), oc_string_len(res->uri));
+  entry->next_by_href = rd_links_by_href[b];
+  rd_links_by_href[b] = entry;
+  return true;
+}
+
+static void
+rd_link_unindex(oc_link_t *link)
+{
+  oc_resource_t *res = link->resource;
+  if (!res) {
+    return;
+  }
+  rd_link_entry_t *entry = NULL;
+  rd_link_entry_t **e = &rd_links_by_resource[rd_resource_bucket(res)];
+  while (*e) {
+    if ((*e)->link == link) {
+      entry = *e;
+      *e = entry->next_by_resource;
+      break;
+    }
+    e = &(*e)->next_by_resource;
+  }
+  if (!entry) {
+    return;
+  }
+  e = &rd_links_by_href[rd_href_bucket(res->device, oc_string(res->uri),
+                                       oc_string_len(res->uri))];
+  while (*e) {
+    if (*e == entry) {
+      *e = entry->next_by_href;
+      break;
+    }
+    e = &(*e)->next_by_href;
+  }
+  oc_memb_free(&rd_link_entries_s, entry);
 }
 
 static void
@@ -69,21 +183,11 @@ rd_link_free(oc_link_t **head)
 {
   for (oc_link_t *link = rd_link_pop(head); link != NULL;
        link = rd_link_pop(head)) {
+    rd_link_unindex(link);
     oc_delete_link(link);
   }
 }
 
-static oc_link_t *
-rd_link_find_by_href(oc_link_t *head, const char *href, size_t href_size)
-{
-  oc_link_t *iter = head;
-  while (iter != NULL && oc_string_len(iter->resource->uri) != href_size &&
-         !strncmp(oc_string(iter->resource->uri), href, href_size)) {
-    iter = iter->next;
-  }
-  return iter;
-}
-
 static oc_link_t *
 rd_link_remove(oc_link_t **head, oc_link_t *l)
 {
@@ -97,12 +201,6 @@ rd_link_remove(oc_link_t **head, oc_link_t *l)
   return l;
 }
 
-static oc_link_t *
-rd_link_remove_by_resource(oc_link_t **head, oc_resource_t *res)
-{
-  return rd_link_remove(head, rd_link_find(*head, res));
-}
-
 static void
 publish_resources_handler(oc_client_response_t *data)
 {
@@ -124,12 +222,13 @@ publish_resources_handler(oc_client_response_t *data)
                             &href_size) &&
           oc_rep_get_int(link->value.object, OC_RSRVD_INSTANCEID,
                          &instance_id)) {
-        oc_link_t *l =
-          rd_link_find_by_href(ctx->rd_publish_resources, href, href_size);
-        if (l) {
-          l->ins = instance_id;
-          rd_link_remove(&ctx->rd_publish_resources, l);
-          rd_link_add(&ctx->rd_publish_resources, l);
+        rd_link_entry_t *entry =
+          rd_link_find_by_href(ctx->device, href, href_size);
+        if (entry && !entry->published) {
+          entry->link->ins = instance_id;
+          entry->published = true;
+          rd_link_remove(&ctx->rd_publish_resources, entry->link);
+          rd_link_add(&ctx->rd_published_resources, entry->link);
         }
       }
       link = link->next;
@@ -159,6 +258,35 @@ publish_resources(oc_cloud_context_t *ctx)
              publish_resources_handler, LOW_QOS, ctx);
 }
 
+static void delete_resources(oc_cloud_context_t *ctx, bool all);
+
+static oc_event_callback_retval_t
+flush_resources(void *data)
+{
+  oc_cloud_context_t *ctx = (oc_cloud_context_t *)data;
+  ctx->rd_flush_scheduled = false;
+  if (ctx->rd_publish_resources) {
+    publish_resources(ctx);
+  }
+  delete_resources(ctx, false);
+  return OC_EVENT_DONE;
+}
+
+/* Coalesces the additions and deletions made within the publish window into
+ * a single publish and a single delete request.
+ */
+static void
+schedule_flush_resources(oc_cloud_context_t *ctx)
+{
+  if (ctx->rd_flush_scheduled) {
+    return;
+  }
+  ctx->rd_flush_scheduled = true;
+  oc_ri_add_timed_event_callback_ticks(
+    ctx, flush_resources,
+    (oc_clock_time_t)OC_CLOUD_RD_PUBLISH_DELAY_MS * OC_CLOCK_SECOND / 1000);
+}
+
 int
 oc_cloud_add_resource(oc_resource_t *res)
 {
@@ -166,23 +294,20 @@ oc_cloud_add_resource(oc_resource_t *res)
   if (ctx == NULL) {
     return -1;
   }
-  oc_link_t *publish = rd_link_find(ctx->rd_publish_resources, res);
-  if (publish) {
+  if (rd_link_find(res)) {
     return 0;
   }
-  oc_link_t *published = rd_link_find(ctx->rd_published_resources, res);
-  if (published) {
-    return 0;
-  }
-  oc_link_t *delete =
-    rd_link_remove_by_resource(&ctx->rd_delete_resources, res);
-  if (delete) {
-    oc_delete_link(delete);
-  }
 
   oc_link_t *link = oc_new_link(res);
+  if (!link) {
+    return -1;
+  }
+  if (!rd_link_index(link)) {
+    oc_delete_link(link);
+    return -1;
+  }
   rd_link_add(&ctx->rd_publish_resources, link);
-  publish_resources(ctx);
+  schedule_flush_resources(ctx);
   return 0;
 }
 
@@ -191,6 +316,10 @@ move_published_to_publish_resources(oc_cloud_context_t *ctx)
 {
   while (ctx->rd_published_resources) {
     oc_link_t *link = rd_link_pop(&ctx->rd_published_resources);
+    rd_link_entry_t *entry = rd_link_find(link->resource);
+    if (entry) {
+      entry->published = false;
+    }
     rd_link_add(&ctx->rd_publish_resources, link);
   }
 }
@@ -251,19 +380,57 @@ void
 cloud_rd_manager_status_changed(oc_cloud_context_t *ctx)
 {
   if (ctx->store.status & OC_CLOUD_LOGGED_IN) {
-    publish_published_resources(ctx);
-    delete_resources(ctx, false);
+    oc_remove_delayed_callback(ctx, flush_resources);
+    ctx->rd_flush_scheduled = false;
+    /* The same requests already went out behind the sign-in request. */
+    if (!ctx->rd_flush_pipelined) {
+      publish_published_resources(ctx);
+      delete_resources(ctx, false);
+    }
     oc_remove_delayed_callback(ctx, publish_published_resources);
     oc_set_delayed_callback(ctx, publish_published_resources, ONE_HOUR);
   } else {
     oc_remove_delayed_callback(ctx, publish_published_resources);
   }
+  ctx->rd_flush_pipelined = false;
+}
+
+/* Called while a re-sign-in is in flight, before OC_CLOUD_LOGGED_IN is set
+ * again, so the requests are sent without waiting for it. Sends what
+ * cloud_rd_manager_status_changed would send after the sign-in, which then
+ * skips it.
+ */
+void
+cloud_rd_flush(oc_cloud_context_t *ctx)
+{
+  oc_remove_delayed_callback(ctx, flush_resources);
+  ctx->rd_flush_scheduled = false;
+  ctx->rd_flush_pipelined = false;
+#ifdef OC_SECURITY
+  oc_sec_pstat_t *pstat = oc_sec_get_pstat(ctx->device);
+  if (pstat->s != OC_DOS_RFNOP) {
+    return;
+  }
+#endif /* OC_SECURITY */
+  ctx->rd_flush_pipelined = true;
+  move_published_to_publish_resources(ctx);
+  if (ctx->rd_publish_resources) {
+    rd_publish(ctx->cloud_ep, ctx->rd_publish_resources, ctx->device,
+               publish_resources_handler, LOW_QOS, ctx);
+  }
+  if (ctx->rd_delete_resources) {
+    rd_delete(ctx->cloud_ep, ctx->rd_delete_resources, ctx->device,
+              delete_resources_handler, LOW_QOS, ctx);
+  }
 }
 
 void
 cloud_rd_deinit(oc_cloud_context_t *ctx)
 {
   oc_remove_delayed_callback(ctx, publish_published_resources);
+  oc_remove_delayed_callback(ctx, flush_resources);
+  ctx->rd_flush_scheduled = false;
+  ctx->rd_flush_pipelined = false;
 
   rd_link_free(&ctx->rd_delete_resources);
   rd_link_free(&ctx->rd_published_resources);
@@ -277,20 +444,22 @@ oc_cloud_delete_resource(oc_resource_t *res)
   if (ctx == NULL) {
     return;
   }
-  oc_link_t *publish =
-    rd_link_remove_by_resource(&ctx->rd_publish_resources, res);
-  if (publish != NULL) {
-    oc_delete_link(publish);
+  rd_link_entry_t *entry = rd_link_find(res);
+  if (entry == NULL) {
+    return;
   }
-  oc_link_t *published =
-    rd_link_remove_by_resource(&ctx->rd_published_resources, res);
-  if (published != NULL) {
-    if (published->resource) {
-      published->resource = NULL;
-    }
-    rd_link_add(&ctx->rd_delete_resources, published);
-    delete_resources(ctx, false);
+  oc_link_t *link = entry->link;
+  bool published = entry->published;
+  rd_link_unindex(link);
+  if (!published) {
+    rd_link_remove(&ctx->rd_publish_resources, link);
+    oc_delete_link(link);
+    return;
   }
+  rd_link_remove(&ctx->rd_published_resources, link);
+  link->resource = NULL;
+  rd_link_add(&ctx->rd_delete_resources, link);
+  schedule_flush_resources(ctx);
 }
 
 int
@@ -298,6 +467,8 @@ oc_cloud_publish_resources(size_t device)
 {
   oc_cloud_context_t *ctx = oc_cloud_get_context(device);
   if (ctx) {
+    oc_remove_delayed_callback(ctx, flush_resources);
+    ctx->rd_flush_scheduled = false;
     publish_published_resources(ctx);
     delete_resources(ctx, false);
     return 0;
@@ -19,8 +19,10 @@
 #ifdef OC_BLOCK_WISE
 #include "oc_blockwise.h"
 #include "oc_endpoint.h"
+#include "oc_metrics.h"
 #include "port/oc_log.h"
 #include "util/oc_list.h"
+#include "util/oc_mem_budget.h"
 #include "util/oc_memb.h"
 
 OC_MEMB(oc_blockwise_request_states_s, oc_blockwise_request_state_t,
@@ -38,14 +40,24 @@ oc_blockwise_init_buffer(struct oc_memb *pool, const char *href,
   if (href_len == 0)
     return NULL;
 
+  if (!OC_MEM_CHARGE(OC_MEM_BLOCKWISE, pool->size)) {
+    return NULL;
+  }
   oc_blockwise_state_t *buffer = (oc_blockwise_state_t *)oc_memb_alloc(pool);
   if (buffer) {
 #ifdef OC_DYNAMIC_ALLOCATION
+    if (!OC_MEM_CHARGE(OC_MEM_BLOCKWISE, OC_MAX_APP_DATA_SIZE)) {
+      oc_memb_free(pool, buffer);
+      OC_MEM_RELEASE(OC_MEM_BLOCKWISE, pool->size);
+      return NULL;
+    }
     buffer->buffer = (uint8_t *)malloc(OC_MAX_APP_DATA_SIZE);
     if (!buffer->buffer) {
       oc_memb_free(pool, buffer);
+      OC_MEM_RELEASE(OC_MEM_BLOCKWISE, pool->size + OC_MAX_APP_DATA_SIZE);
       return NULL;
     }
+    buffer->external_buffer = false;
 #endif /* OC_DYNAMIC_ALLOCATION */
     buffer->next_block_offset = 0;
     buffer->payload_size = 0;
@@ -62,6 +74,7 @@ oc_blockwise_init_buffer(struct oc_memb *pool, const char *href,
 #endif /* OC_CLIENT */
     return buffer;
   }
+  OC_MEM_RELEASE(OC_MEM_BLOCKWISE, pool->size);
   OC_WRN("block-wise buffers exhausted");
   return NULL;
 }
@@ -82,15 +95,21 @@ oc_blockwise_free_buffer(oc_list_t list, struct oc_memb *pool,
   oc_free_string(&buffer->href);
   oc_list_remove(list, buffer);
 #ifdef OC_DYNAMIC_ALLOCATION
-  free(buffer->buffer);
+  if (!buffer->external_buffer) {
+    free(buffer->buffer);
+    OC_MEM_RELEASE(OC_MEM_BLOCKWISE, OC_MAX_APP_DATA_SIZE);
+  }
   buffer->buffer = NULL;
+  buffer->external_buffer = false;
 #endif
   oc_memb_free(pool, buffer);
+  OC_MEM_RELEASE(OC_MEM_BLOCKWISE, pool->size);
 }
 
 static oc_event_callback_retval_t
 oc_blockwise_request_timeout(void *data)
 {
+  OC_METRICS_INC(OC_METRICS_BLOCKWISE_TIMEOUTS);
   oc_blockwise_free_buffer(oc_blockwise_requests,
                            &oc_blockwise_request_states_s, data);
   return OC_EVENT_DONE;
@@ -99,6 +118,7 @@ oc_blockwise_request_timeout(void *data)
 static oc_event_callback_retval_t
 oc_blockwise_response_timeout(void *data)
 {
+  OC_METRICS_INC(OC_METRICS_BLOCKWISE_TIMEOUTS);
   oc_blockwise_free_buffer(oc_blockwise_responses,
                            &oc_blockwise_response_states_s, data);
   return OC_EVENT_DONE;
@@ -150,14 +170,16 @@ void
 oc_blockwise_free_request_buffer(oc_blockwise_state_t *buffer)
 {
   oc_ri_remove_timed_event_callback(buffer, oc_blockwise_request_timeout);
-  oc_blockwise_request_timeout(buffer);
+  oc_blockwise_free_buffer(oc_blockwise_requests,
+                           &oc_blockwise_request_states_s, buffer);
 }
 
 void
 oc_blockwise_free_response_buffer(oc_blockwise_state_t *buffer)
 {
   oc_ri_remove_timed_event_callback(buffer, oc_blockwise_response_timeout);
-  oc_blockwise_response_timeout(buffer);
+  oc_blockwise_free_buffer(oc_blockwise_responses,
+                           &oc_blockwise_response_states_s, buffer);
 }
 
 #ifdef OC_CLIENT
@@ -184,6 +206,28 @@ oc_blockwise_scrub_buffers_for_client_cb(void *cb)
 }
 #endif /* OC_CLIENT */
 
+bool
+oc_blockwise_evict_oldest(void)
+{
+  /* Buffers are appended as transfers start, so the head of each list is
+   * the oldest. Cached responses are cheaper to lose than requests that are
+   * still being assembled.
+   */
+  oc_blockwise_state_t *buffer = oc_list_head(oc_blockwise_responses);
+  if (buffer) {
+    OC_DBG("evicting the oldest block-wise response buffer");
+    oc_blockwise_free_response_buffer(buffer);
+    return true;
+  }
+  buffer = oc_list_head(oc_blockwise_requests);
+  if (buffer) {
+    OC_DBG("evicting the oldest block-wise request buffer");
+    oc_blockwise_free_request_buffer(buffer);
+    return true;
+  }
+  return false;
+}
+
 void
 oc_blockwise_scrub_buffers(bool all)
 {
@@ -332,6 +376,37 @@ oc_blockwise_find_response_buffer(const char *href, size_t href_len,
                                   endpoint, method, query, query_len, role);
 }
 
+static oc_blockwise_state_t *
+oc_blockwise_find_buffer_by_endpoint(oc_list_t list, oc_endpoint_t *endpoint,
+                                     oc_blockwise_role_t role)
+{
+  oc_blockwise_state_t *buffer = oc_list_head(list);
+  while (buffer) {
+    if (buffer->role == role &&
+        oc_endpoint_compare(&buffer->endpoint, endpoint) == 0) {
+      break;
+    }
+    buffer = buffer->next;
+  }
+  return buffer;
+}
+
+oc_blockwise_state_t *
+oc_blockwise_find_request_buffer_by_endpoint(oc_endpoint_t *endpoint,
+                                             oc_blockwise_role_t role)
+{
+  return oc_blockwise_find_buffer_by_endpoint(oc_blockwise_requests, endpoint,
+                                              role);
+}
+
+oc_blockwise_state_t *
+oc_blockwise_find_response_buffer_by_endpoint(oc_endpoint_t *endpoint,
+                                              oc_blockwise_role_t role)
+{
+  return oc_blockwise_find_buffer_by_endpoint(oc_blockwise_responses, endpoint,
+                                              role);
+}
+
 const void *
 oc_blockwise_dispatch_block(oc_blockwise_state_t *buffer, uint32_t block_offset,
                             uint32_t requested_block_size,
@@ -350,6 +425,34 @@ oc_blockwise_dispatch_block(oc_blockwise_state_t *buffer, uint32_t block_offset,
   return NULL;
 }
 
+#ifdef OC_DYNAMIC_ALLOCATION
+void
+oc_blockwise_set_external_payload(oc_blockwise_state_t *buffer,
+                                  const uint8_t *payload, uint32_t payload_size)
+{
+  if (!buffer->external_buffer) {
+    free(buffer->buffer);
+    OC_MEM_RELEASE(OC_MEM_BLOCKWISE, OC_MAX_APP_DATA_SIZE);
+  }
+  buffer->buffer = (uint8_t *)payload;
+  buffer->external_buffer = true;
+  buffer->payload_size = payload_size;
+}
+
+void
+oc_blockwise_release_external_payload(const uint8_t *payload)
+{
+  oc_blockwise_state_t *buffer = oc_list_head(oc_blockwise_responses), *next;
+  while (buffer != NULL) {
+    next = buffer->next;
+    if (buffer->external_buffer && buffer->buffer == payload) {
+      oc_blockwise_free_response_buffer(buffer);
+    }
+    buffer = next;
+  }
+}
+#endif /* OC_DYNAMIC_ALLOCATION */
+
 bool
 oc_blockwise_handle_block(oc_blockwise_state_t *buffer,
                           uint32_t incoming_block_offset,
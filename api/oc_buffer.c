@@ -17,6 +17,7 @@
 #include "messaging/coap/engine.h"
 #include "oc_signal_event_loop.h"
 #include "port/oc_network_events_mutex.h"
+#include "util/oc_mem_budget.h"
 #include "util/oc_memb.h"
 #include <stdint.h>
 #include <stdio.h>
@@ -31,14 +32,32 @@
 #include "oc_buffer.h"
 #include "oc_config.h"
 #include "oc_events.h"
+#include "oc_metrics.h"
+#include "oc_trace.h"
 
 OC_PROCESS(message_buffer_handler, "OC Message Buffer Handler");
 OC_MEMB(oc_incoming_buffers, oc_message_t, OC_MAX_NUM_CONCURRENT_REQUESTS);
 OC_MEMB(oc_outgoing_buffers, oc_message_t, OC_MAX_NUM_CONCURRENT_REQUESTS);
 
+#ifdef OC_DYNAMIC_ALLOCATION
+#define MESSAGE_SIZE (sizeof(oc_message_t) + OC_PDU_SIZE)
+#else /* OC_DYNAMIC_ALLOCATION */
+#define MESSAGE_SIZE (sizeof(oc_message_t))
+#endif /* !OC_DYNAMIC_ALLOCATION */
+
 static oc_message_t *
 allocate_message(struct oc_memb *pool)
 {
+#ifdef OC_MEMORY_BUDGET
+  /* New work is refused while an enforced hard limit is reached. */
+  if (pool == &oc_incoming_buffers && oc_mem_budget_exhausted()) {
+    OC_WRN("buffer: memory budget exhausted, refusing incoming message");
+    return NULL;
+  }
+#endif /* OC_MEMORY_BUDGET */
+  if (!OC_MEM_CHARGE(OC_MEM_MESSAGES, MESSAGE_SIZE)) {
+    return NULL;
+  }
   oc_network_event_handler_mutex_lock();
   oc_message_t *message = (oc_message_t *)oc_memb_alloc(pool);
   oc_network_event_handler_mutex_unlock();
@@ -47,6 +66,7 @@ allocate_message(struct oc_memb *pool)
     message->data = malloc(OC_PDU_SIZE);
     if (!message->data) {
       oc_memb_free(pool, message);
+      OC_MEM_RELEASE(OC_MEM_MESSAGES, MESSAGE_SIZE);
       return NULL;
     }
 #endif /* OC_DYNAMIC_ALLOCATION */
@@ -63,11 +83,12 @@ allocate_message(struct oc_memb *pool)
            oc_memb_numfree(pool));
 #endif /* !OC_DYNAMIC_ALLOCATION */
   }
-#ifndef OC_DYNAMIC_ALLOCATION
   else {
+    OC_MEM_RELEASE(OC_MEM_MESSAGES, MESSAGE_SIZE);
+#ifndef OC_DYNAMIC_ALLOCATION
     OC_WRN("buffer: No free TX/RX buffers!");
-  }
 #endif /* !OC_DYNAMIC_ALLOCATION */
+  }
   return message;
 }
 
@@ -116,6 +137,7 @@ oc_message_unref(oc_message_t *message)
 #endif /* OC_DYNAMIC_ALLOCATION */
       struct oc_memb *pool = message->pool;
       oc_memb_free(pool, message);
+      OC_MEM_RELEASE(OC_MEM_MESSAGES, MESSAGE_SIZE);
 #ifndef OC_DYNAMIC_ALLOCATION
       OC_DBG("buffer: freed TX/RX buffer; num free: %d", oc_memb_numfree(pool));
 #endif /* !OC_DYNAMIC_ALLOCATION */
@@ -123,21 +145,66 @@ oc_message_unref(oc_message_t *message)
   }
 }
 
+/* DTLS record content type of handshake messages. */
+#define DTLS_CONTENT_HANDSHAKE (22)
+
+/* Inbound CoAP ACK and RST messages complete transactions that are
+ * otherwise retransmitted, and DTLS handshakes time out, so both are
+ * handled ahead of new requests. Only datagrams are classified; messages
+ * of a TCP session must stay in order.
+ */
+static oc_process_prio_t
+inbound_priority(oc_message_t *message)
+{
+  if (message->length == 0
+#ifdef OC_TCP
+      || (message->endpoint.flags & TCP)
+#endif /* OC_TCP */
+  ) {
+    return OC_PROCESS_PRIO_NORMAL;
+  }
+#ifdef OC_SECURITY
+  if (message->encrypted) {
+    return (message->data[0] == DTLS_CONTENT_HANDSHAKE)
+             ? OC_PROCESS_PRIO_HANDSHAKE
+             : OC_PROCESS_PRIO_NORMAL;
+  }
+#endif /* OC_SECURITY */
+  switch ((message->data[0] & COAP_HEADER_TYPE_MASK) >>
+          COAP_HEADER_TYPE_POSITION) {
+  case COAP_TYPE_ACK:
+  case COAP_TYPE_RST:
+    return OC_PROCESS_PRIO_HIGH;
+  default:
+    return OC_PROCESS_PRIO_NORMAL;
+  }
+}
+
 void
 oc_recv_message(oc_message_t *message)
 {
-  if (oc_process_post(&message_buffer_handler, oc_events[INBOUND_NETWORK_EVENT],
-                      message) == OC_PROCESS_ERR_FULL)
+  OC_TRACE_MESSAGE(OC_TRACE_RECV_MESSAGE, message);
+  if (oc_process_post_prio(&message_buffer_handler,
+                           oc_events[INBOUND_NETWORK_EVENT], message,
+                           inbound_priority(message)) == OC_PROCESS_ERR_FULL) {
+    OC_METRICS_INC(OC_METRICS_MESSAGES_DROPPED_IN);
     oc_message_unref(message);
+    return;
+  }
+  OC_METRICS_INC(OC_METRICS_MESSAGES_RECEIVED);
 }
 
 void
 oc_send_message(oc_message_t *message)
 {
-  if (oc_process_post(&message_buffer_handler,
-                      oc_events[OUTBOUND_NETWORK_EVENT],
-                      message) == OC_PROCESS_ERR_FULL)
+  if (oc_process_post_prio(&message_buffer_handler,
+                           oc_events[OUTBOUND_NETWORK_EVENT], message,
+                           OC_PROCESS_PRIO_HIGH) == OC_PROCESS_ERR_FULL) {
+    OC_METRICS_INC(OC_METRICS_MESSAGES_DROPPED_OUT);
     message->ref_count--;
+  } else {
+    OC_METRICS_INC(OC_METRICS_MESSAGES_SENT);
+  }
 
   _oc_signal_event_loop();
 }
@@ -146,8 +213,9 @@ oc_send_message(oc_message_t *message)
 void
 oc_close_all_tls_sessions_for_device(size_t device)
 {
-  oc_process_post(&message_buffer_handler, oc_events[TLS_CLOSE_ALL_SESSIONS],
-                  (oc_process_data_t)device);
+  oc_process_post_prio(&message_buffer_handler,
+                       oc_events[TLS_CLOSE_ALL_SESSIONS],
+                       (oc_process_data_t)device, OC_PROCESS_PRIO_LOW);
 }
 
 void
@@ -166,17 +234,21 @@ OC_PROCESS_THREAD(message_buffer_handler, ev, data)
     OC_PROCESS_YIELD();
 
     if (ev == oc_events[INBOUND_NETWORK_EVENT]) {
+      oc_process_prio_t prio = inbound_priority((oc_message_t *)data);
 #ifdef OC_SECURITY
       if (((oc_message_t *)data)->encrypted == 1) {
         OC_DBG("Inbound network event: encrypted request");
-        oc_process_post(&oc_tls_handler, oc_events[UDP_TO_TLS_EVENT], data);
+        oc_process_post_prio(&oc_tls_handler, oc_events[UDP_TO_TLS_EVENT],
+                             data, prio);
       } else {
         OC_DBG("Inbound network event: decrypted request");
-        oc_process_post(&coap_engine, oc_events[INBOUND_RI_EVENT], data);
+        oc_process_post_prio(&coap_engine, oc_events[INBOUND_RI_EVENT], data,
+                             prio);
       }
 #else  /* OC_SECURITY */
       OC_DBG("Inbound network event: decrypted request");
-      oc_process_post(&coap_engine, oc_events[INBOUND_RI_EVENT], data);
+      oc_process_post_prio(&coap_engine, oc_events[INBOUND_RI_EVENT], data,
+                           prio);
 #endif /* !OC_SECURITY */
     } else if (ev == oc_events[OUTBOUND_NETWORK_EVENT]) {
       oc_message_t *message = (oc_message_t *)data;
@@ -195,13 +267,15 @@ OC_PROCESS_THREAD(message_buffer_handler, ev, data)
 #ifdef OC_CLIENT
         if (!oc_tls_connected(&message->endpoint)) {
           OC_DBG("Posting INIT_TLS_CONN_EVENT");
-          oc_process_post(&oc_tls_handler, oc_events[INIT_TLS_CONN_EVENT],
-                          data);
+          oc_process_post_prio(&oc_tls_handler,
+                               oc_events[INIT_TLS_CONN_EVENT], data,
+                               OC_PROCESS_PRIO_HANDSHAKE);
         } else
 #endif /* OC_CLIENT */
         {
           OC_DBG("Posting RI_TO_TLS_EVENT");
-          oc_process_post(&oc_tls_handler, oc_events[RI_TO_TLS_EVENT], data);
+          oc_process_post_prio(&oc_tls_handler, oc_events[RI_TO_TLS_EVENT],
+                               data, OC_PROCESS_PRIO_HIGH);
         }
       } else
 #endif /* OC_SECURITY */
@@ -214,7 +288,8 @@ OC_PROCESS_THREAD(message_buffer_handler, ev, data)
 #ifdef OC_SECURITY
     else if (ev == oc_events[TLS_CLOSE_ALL_SESSIONS]) {
       OC_DBG("Signaling to close all TLS sessions from this device");
-      oc_process_post(&oc_tls_handler, oc_events[TLS_CLOSE_ALL_SESSIONS], data);
+      oc_process_post_prio(&oc_tls_handler, oc_events[TLS_CLOSE_ALL_SESSIONS],
+                           data, OC_PROCESS_PRIO_LOW);
     }
 #endif /* OC_SECURITY */
   }
@@ -555,6 +555,7 @@ oc_do_site_local_ipv6_discovery_all(oc_discovery_all_handler_t handler,
   oc_client_handler_t handlers;
   handlers.discovery_all = handler;
   handlers.discovery = NULL;
+  handlers.discovery_changes = NULL;
   return multi_scope_ipv6_discovery(NULL, 0x05, NULL, handlers, user_data);
 }
 
@@ -565,6 +566,7 @@ oc_do_site_local_ipv6_discovery(const char *rt, oc_discovery_handler_t handler,
   oc_client_handler_t handlers;
   handlers.discovery = handler;
   handlers.discovery_all = NULL;
+  handlers.discovery_changes = NULL;
   oc_string_t uri_query;
   memset(&uri_query, 0, sizeof(oc_string_t));
   if (rt && strlen(rt) > 0) {
@@ -585,6 +587,7 @@ oc_do_realm_local_ipv6_discovery_all(oc_discovery_all_handler_t handler,
   oc_client_handler_t handlers;
   handlers.discovery_all = handler;
   handlers.discovery = NULL;
+  handlers.discovery_changes = NULL;
   return multi_scope_ipv6_discovery(NULL, 0x03, NULL, handlers, user_data);
 }
 
@@ -595,6 +598,7 @@ oc_do_realm_local_ipv6_discovery(const char *rt, oc_discovery_handler_t handler,
   oc_client_handler_t handlers;
   handlers.discovery = handler;
   handlers.discovery_all = NULL;
+  handlers.discovery_changes = NULL;
   oc_string_t uri_query;
   memset(&uri_query, 0, sizeof(oc_string_t));
   if (rt && strlen(rt) > 0) {
@@ -615,6 +619,7 @@ oc_do_ip_discovery(const char *rt, oc_discovery_handler_t handler,
   oc_client_handler_t handlers;
   handlers.discovery = handler;
   handlers.discovery_all = NULL;
+  handlers.discovery_changes = NULL;
   oc_string_t uri_query;
   memset(&uri_query, 0, sizeof(oc_string_t));
   if (rt && strlen(rt) > 0) {
@@ -639,6 +644,23 @@ oc_do_ip_discovery_all(oc_discovery_all_handler_t handler, void *user_data)
   oc_client_handler_t handlers;
   handlers.discovery_all = handler;
   handlers.discovery = NULL;
+  handlers.discovery_changes = NULL;
+#ifdef OC_IPV4
+  cb4 = oc_do_ipv4_discovery(NULL, handlers, user_data);
+#endif
+  return multi_scope_ipv6_discovery(cb4, 0x02, NULL, handlers, user_data);
+}
+
+bool
+oc_do_ip_discovery_changes(oc_discovery_changes_handler_t handler,
+                           void *user_data)
+{
+  oc_client_cb_t *cb4 = NULL;
+  oc_client_handler_t handlers;
+  handlers.discovery_changes = handler;
+  handlers.discovery_all = NULL;
+  handlers.discovery = NULL;
+  oc_ri_expire_discovery_cache(handler, user_data);
 #ifdef OC_IPV4
   cb4 = oc_do_ipv4_discovery(NULL, handlers, user_data);
 #endif
@@ -652,6 +674,7 @@ oc_do_ip_discovery_all_at_endpoint(oc_discovery_all_handler_t handler,
   oc_client_handler_t handlers;
   handlers.discovery_all = handler;
   handlers.discovery = NULL;
+  handlers.discovery_changes = NULL;
   return dispatch_ip_discovery(NULL, NULL, handlers, endpoint, user_data);
 }
 
@@ -662,6 +685,7 @@ oc_do_ip_discovery_at_endpoint(const char *rt, oc_discovery_handler_t handler,
   oc_client_handler_t handlers;
   handlers.discovery = handler;
   handlers.discovery_all = NULL;
+  handlers.discovery_changes = NULL;
   oc_string_t uri_query;
   memset(&uri_query, 0, sizeof(oc_string_t));
   if (rt && strlen(rt) > 0) {
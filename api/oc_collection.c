@@ -18,6 +18,7 @@
 
 #if defined(OC_COLLECTIONS) && defined(OC_SERVER)
 #include "messaging/coap/observe.h"
+#include "messaging/coap/separate.h"
 #include "oc_api.h"
 #include "oc_core_res.h"
 #ifdef OC_COLLECTIONS_IF_CREATE
@@ -43,6 +44,208 @@ OC_LIST(rt_factories);
 OC_LIST(params_list);
 #endif /* OC_COLLECTIONS_IF_CREATE */
 
+#ifndef OC_COLLECTION_LINK_BUCKETS
+#ifdef OC_DYNAMIC_ALLOCATION
+#define OC_COLLECTION_LINK_BUCKETS (64)
+#else /* OC_DYNAMIC_ALLOCATION */
+#define OC_COLLECTION_LINK_BUCKETS (OC_MAX_APP_RESOURCES)
+#endif /* !OC_DYNAMIC_ALLOCATION */
+#endif /* !OC_COLLECTION_LINK_BUCKETS */
+
+/* Links of all collections hashed by their target resource, and by their
+ * owning collection and href
+ */
+static oc_link_t *links_by_resource[OC_COLLECTION_LINK_BUCKETS];
+static oc_link_t *links_by_href[OC_COLLECTION_LINK_BUCKETS];
+
+/* A collection that links to a resource, counted once however many of its
+ * links point at the resource
+ */
+typedef struct oc_collection_ref_s
+{
+  struct oc_collection_ref_s *next;
+  oc_resource_t *resource;
+  oc_collection_t *collection;
+  size_t num_links;
+} oc_collection_ref_t;
+
+/* Collections linking to each resource, hashed by the resource and kept in
+ * the order of their first link to it
+ */
+static oc_collection_ref_t *collections_by_resource[OC_COLLECTION_LINK_BUCKETS];
+/* Allocator for collection references, of which there are never more than
+ * links
+ */
+OC_MEMB(oc_collection_refs_s, oc_collection_ref_t, OC_MAX_APP_RESOURCES);
+
+/* A batch link whose handler deferred its response. Its {href, rep} map is
+ * encoded into the buffer of its handle, and appended to the links array of
+ * the batch response once the handler completes.
+ */
+typedef struct oc_batch_link_s
+{
+  struct oc_batch_link_s *next;
+  oc_separate_response_t *handle;
+  oc_string_t href;
+  CborEncoder encoder;
+  CborEncoder map;
+  int err;
+  size_t rep_offset;
+  bool encoding;
+} oc_batch_link_t;
+
+/* An oic.if.b response that is assembled as deferred links complete */
+typedef struct oc_batch_response_s
+{
+  struct oc_batch_response_s *next;
+  oc_separate_response_t response;
+  CborEncoder encoder;
+  CborEncoder links;
+  OC_LIST_STRUCT(pending);
+} oc_batch_response_t;
+
+/* Every batch response holds a full response buffer, so static builds only
+ * reserve them when the port configuration defines OC_MAX_BATCH_RESPONSES.
+ */
+#if defined(OC_DYNAMIC_ALLOCATION) && !defined(OC_MAX_BATCH_RESPONSES)
+#define OC_MAX_BATCH_RESPONSES (1)
+#endif /* OC_DYNAMIC_ALLOCATION && !OC_MAX_BATCH_RESPONSES */
+
+OC_LIST(batch_responses);
+#ifdef OC_MAX_BATCH_RESPONSES
+/* Allocator for batch responses */
+OC_MEMB(oc_batch_responses_s, oc_batch_response_t, OC_MAX_BATCH_RESPONSES);
+#endif /* OC_MAX_BATCH_RESPONSES */
+/* Allocator for deferred batch links */
+OC_MEMB(oc_batch_links_s, oc_batch_link_t, OC_MAX_APP_RESOURCES);
+/* The deferred batch link that g_encoder currently encodes into */
+static oc_batch_link_t *open_link;
+
+static size_t
+resource_bucket(const oc_resource_t *resource)
+{
+  return (size_t)(((uintptr_t)resource >> 3) % OC_COLLECTION_LINK_BUCKETS);
+}
+
+static size_t
+href_bucket(const oc_collection_t *collection, const char *href,
+            size_t href_len)
+{
+  uint32_t hash = 5381;
+  while (href_len > 0 && href[0] == '/') {
+    href++;
+    href_len--;
+  }
+  size_t i;
+  for (i = 0; i < href_len; i++) {
+    hash = ((hash << 5) + hash) + (uint8_t)href[i];
+  }
+  hash ^= (uint32_t)((uintptr_t)collection >> 3);
+  return (size_t)(hash % OC_COLLECTION_LINK_BUCKETS);
+}
+
+static void
+ref_collection(oc_collection_t *collection, oc_resource_t *resource)
+{
+  oc_collection_ref_t **r = &collections_by_resource[resource_bucket(resource)];
+  while (*r) {
+    if ((*r)->resource == resource && (*r)->collection == collection) {
+      (*r)->num_links++;
+      return;
+    }
+    r = &(*r)->next;
+  }
+  oc_collection_ref_t *ref = oc_memb_alloc(&oc_collection_refs_s);
+  if (!ref) {
+    OC_WRN("insufficient memory to index collection link");
+    return;
+  }
+  ref->next = NULL;
+  ref->resource = resource;
+  ref->collection = collection;
+  ref->num_links = 1;
+  *r = ref;
+}
+
+static void
+unref_collection(oc_collection_t *collection, oc_resource_t *resource)
+{
+  oc_collection_ref_t **r = &collections_by_resource[resource_bucket(resource)];
+  while (*r) {
+    oc_collection_ref_t *ref = *r;
+    if (ref->resource == resource && ref->collection == collection) {
+      if (--ref->num_links == 0) {
+        *r = ref->next;
+        oc_memb_free(&oc_collection_refs_s, ref);
+      }
+      return;
+    }
+    r = &ref->next;
+  }
+}
+
+static void
+index_link(oc_collection_t *collection, oc_link_t *link)
+{
+  link->collection = collection;
+  ref_collection(collection, link->resource);
+  size_t b = resource_bucket(link->resource);
+  link->next_by_resource = links_by_resource[b];
+  links_by_resource[b] = link;
+  b = href_bucket(collection, oc_string(link->resource->uri),
+                  oc_string_len(link->resource->uri));
+  link->next_by_href = links_by_href[b];
+  links_by_href[b] = link;
+}
+
+static void
+unindex_link(oc_link_t *link)
+{
+  if (!link->collection) {
+    return;
+  }
+  unref_collection(link->collection, link->resource);
+  oc_link_t **l = &links_by_resource[resource_bucket(link->resource)];
+  while (*l) {
+    if (*l == link) {
+      *l = link->next_by_resource;
+      break;
+    }
+    l = &(*l)->next_by_resource;
+  }
+  l = &links_by_href[href_bucket(link->collection,
+                                 oc_string(link->resource->uri),
+                                 oc_string_len(link->resource->uri))];
+  while (*l) {
+    if (*l == link) {
+      *l = link->next_by_href;
+      break;
+    }
+    l = &(*l)->next_by_href;
+  }
+  link->collection = NULL;
+  link->next_by_resource = NULL;
+  link->next_by_href = NULL;
+}
+
+/* Returns the next link after prev (or the first link when prev is NULL)
+ * that points collection at resource.
+ */
+static oc_link_t *
+get_link_by_resource(oc_collection_t *collection, oc_resource_t *resource,
+                     oc_link_t *prev)
+{
+  oc_link_t *link =
+    prev ? prev->next_by_resource : links_by_resource[resource_bucket(resource)];
+  while (link) {
+    if (link->resource == resource && link->collection == collection) {
+      break;
+    }
+    link = link->next_by_resource;
+  }
+  return link;
+}
+
 oc_collection_t *
 oc_collection_alloc(void)
 {
@@ -102,6 +305,9 @@ oc_new_link(oc_resource_t *resource)
       link->resource = resource;
       resource->num_links++;
       link->next = 0;
+      link->collection = NULL;
+      link->next_by_resource = NULL;
+      link->next_by_href = NULL;
       link->ins = (int64_t)oc_random_value();
       OC_LIST_STRUCT_INIT(link, params);
       return link;
@@ -115,6 +321,9 @@ void
 oc_delete_link(oc_link_t *link)
 {
   if (link) {
+    if (link->resource) {
+      unindex_link(link);
+    }
     oc_link_params_t *p = (oc_link_params_t *)oc_list_pop(link->params);
     while (p) {
       oc_free_string(&p->key);
@@ -157,6 +366,7 @@ oc_collection_add_link(oc_resource_t *collection, oc_link_t *link)
 {
   oc_collection_t *c = (oc_collection_t *)collection;
   oc_list_add(c->links, link);
+  index_link(c, link);
   if (link->resource == collection) {
     oc_string_array_add_item(link->rel, "self");
   }
@@ -169,10 +379,20 @@ oc_collection_remove_link(oc_resource_t *collection, oc_link_t *link)
   if (collection && link) {
     oc_collection_t *c = (oc_collection_t *)collection;
     oc_list_remove(c->links, link);
+    unindex_link(link);
     oc_set_delayed_callback(collection, links_list_notify_collection, 0);
   }
 }
 
+void
+oc_collection_set_async_batch(oc_resource_t *collection,
+                              uint16_t timeout_seconds)
+{
+  if (collection) {
+    ((oc_collection_t *)collection)->batch_timeout_seconds = timeout_seconds;
+  }
+}
+
 oc_link_t *
 oc_collection_get_links(oc_resource_t *collection)
 {
@@ -233,15 +453,15 @@ oc_get_link_by_uri(oc_collection_t *collection, const char *uri_path,
       uri_path_len--;
     }
 
-    link = oc_list_head(collection->links);
+    link = links_by_href[href_bucket(collection, uri_path, uri_path_len)];
     while (link != NULL) {
-      if (link->resource &&
+      if (link->collection == collection &&
           (int)oc_string_len(link->resource->uri) == (uri_path_len + 1) &&
           strncmp(oc_string(link->resource->uri) + 1, uri_path, uri_path_len) ==
             0) {
         break;
       }
-      link = link->next;
+      link = link->next_by_href;
     }
   }
 
@@ -378,26 +598,284 @@ oc_collection_t *
 oc_get_next_collection_with_link(oc_resource_t *resource,
                                  oc_collection_t *start)
 {
-  oc_collection_t *collection = start;
+  oc_collection_ref_t *ref = collections_by_resource[resource_bucket(resource)];
 
-  if (!collection) {
-    collection = oc_collection_get_all();
-  } else {
-    collection = collection->next;
+  if (start) {
+    while (ref && !(ref->resource == resource && ref->collection == start)) {
+      ref = ref->next;
+    }
+    if (!ref) {
+      return NULL;
+    }
+    ref = ref->next;
+  }
+  while (ref && ref->resource != resource) {
+    ref = ref->next;
   }
 
-  while (collection && collection->device == resource->device) {
-    oc_link_t *link = (oc_link_t *)oc_list_head(collection->links);
-    while (link) {
-      if (link->resource == resource) {
-        return collection;
+  return ref ? ref->collection : NULL;
+}
+
+static oc_batch_response_t *
+alloc_batch_response(void)
+{
+#ifndef OC_MAX_BATCH_RESPONSES
+  return NULL;
+#else  /* !OC_MAX_BATCH_RESPONSES */
+  oc_batch_response_t *batch = oc_memb_alloc(&oc_batch_responses_s);
+  if (!batch) {
+    OC_WRN("insufficient memory to create batch response");
+    return NULL;
+  }
+#ifdef OC_DYNAMIC_ALLOCATION
+  batch->response.buffer = (uint8_t *)malloc(OC_MAX_APP_DATA_SIZE);
+  if (!batch->response.buffer) {
+    OC_WRN("insufficient memory to create batch response");
+    oc_memb_free(&oc_batch_responses_s, batch);
+    return NULL;
+  }
+#endif /* OC_DYNAMIC_ALLOCATION */
+  OC_LIST_STRUCT_INIT(&batch->response, requests);
+  batch->response.active = 0;
+  OC_LIST_STRUCT_INIT(batch, pending);
+  oc_list_add(batch_responses, batch);
+  return batch;
+#endif /* OC_MAX_BATCH_RESPONSES */
+}
+
+static void
+free_batch_link(oc_batch_response_t *batch, oc_batch_link_t *link)
+{
+  if (link == open_link) {
+    open_link = NULL;
+  }
+  oc_list_remove(batch->pending, link);
+  oc_free_string(&link->href);
+  oc_memb_free(&oc_batch_links_s, link);
+}
+
+static void
+free_batch_response(oc_batch_response_t *batch)
+{
+  oc_batch_link_t *link;
+  while ((link = oc_list_head(batch->pending)) != NULL) {
+    free_batch_link(batch, link);
+  }
+  oc_list_remove(batch_responses, batch);
+#ifdef OC_MAX_BATCH_RESPONSES
+  oc_memb_free(&oc_batch_responses_s, batch);
+#endif /* OC_MAX_BATCH_RESPONSES */
+}
+
+static bool
+defer_batch_link(oc_batch_response_t *batch, oc_resource_t *resource,
+                 oc_separate_response_t *handle)
+{
+  /* A handle that is already tracking other requests cannot also deliver
+   * into the batch payload.
+   */
+  if (handle->active) {
+    return false;
+  }
+  oc_batch_link_t *link = oc_memb_alloc(&oc_batch_links_s);
+  if (!link) {
+    OC_WRN("insufficient memory to defer batch link");
+    return false;
+  }
+#ifdef OC_DYNAMIC_ALLOCATION
+  handle->buffer = (uint8_t *)malloc(OC_MAX_APP_DATA_SIZE);
+  if (!handle->buffer) {
+    OC_WRN("insufficient memory to defer batch link");
+    oc_memb_free(&oc_batch_links_s, link);
+    return false;
+  }
+#endif /* OC_DYNAMIC_ALLOCATION */
+  OC_LIST_STRUCT_INIT(handle, requests);
+  handle->active = 1;
+  link->handle = handle;
+  link->rep_offset = 0;
+  link->encoding = false;
+  oc_new_string(&link->href, oc_string(resource->uri),
+                oc_string_len(resource->uri));
+  oc_list_add(batch->pending, link);
+  return true;
+}
+
+static void
+finish_batch_response(oc_batch_response_t *batch)
+{
+  oc_list_remove(batch_responses, batch);
+  oc_batch_link_t *link;
+  while ((link = oc_list_head(batch->pending)) != NULL) {
+    OC_WRN("batch link %s did not respond in time", oc_string(link->href));
+    free_batch_link(batch, link);
+  }
+  oc_rep_new(batch->response.buffer, OC_MAX_APP_DATA_SIZE);
+  memcpy(&g_encoder, &batch->encoder, sizeof(CborEncoder));
+  memcpy(&links_array, &batch->links, sizeof(CborEncoder));
+  oc_rep_end_links_array();
+  oc_send_separate_response(&batch->response, OC_STATUS_OK);
+#ifdef OC_MAX_BATCH_RESPONSES
+  oc_memb_free(&oc_batch_responses_s, batch);
+#endif /* OC_MAX_BATCH_RESPONSES */
+}
+
+static oc_event_callback_retval_t
+batch_response_timeout(void *data)
+{
+  finish_batch_response((oc_batch_response_t *)data);
+  return OC_EVENT_DONE;
+}
+
+static oc_batch_response_t *
+find_batch_link(oc_separate_response_t *handle, oc_batch_link_t **link)
+{
+  oc_batch_response_t *batch = oc_list_head(batch_responses);
+  while (batch != NULL) {
+    oc_batch_link_t *l = oc_list_head(batch->pending);
+    while (l != NULL) {
+      if (l->handle == handle) {
+        *link = l;
+        return batch;
       }
-      link = link->next;
+      l = l->next;
     }
-    collection = collection->next;
+    batch = batch->next;
   }
+  return NULL;
+}
 
-  return collection;
+/* Saves the encoder state of the link being encoded so that another link
+ * can be opened before it completes.
+ */
+static void
+suspend_open_link(void)
+{
+  if (open_link) {
+    memcpy(&open_link->map, &g_encoder, sizeof(CborEncoder));
+    open_link->err = g_err;
+    open_link = NULL;
+  }
+}
+
+static void
+resume_link(oc_batch_link_t *link)
+{
+  oc_rep_new(link->handle->buffer, OC_MAX_APP_DATA_SIZE);
+  memcpy(&g_encoder, &link->map, sizeof(CborEncoder));
+  g_err = link->err;
+  open_link = link;
+}
+
+static void
+open_batch_link(oc_batch_link_t *link)
+{
+  suspend_open_link();
+  oc_rep_new(link->handle->buffer, OC_MAX_APP_DATA_SIZE);
+  memcpy(&link->encoder, &g_encoder, sizeof(CborEncoder));
+  g_err |= cbor_encoder_create_map(&link->encoder, &link->map,
+                                   CborIndefiniteLength);
+  g_err |= cbor_encode_text_string(&link->map, "href", 4);
+  g_err |= cbor_encode_text_string(&link->map, oc_string(link->href),
+                                   oc_string_len(link->href));
+  g_err |= cbor_encode_text_string(&link->map, "rep", 3);
+  link->rep_offset =
+    cbor_encoder_get_buffer_size(&link->map, link->handle->buffer);
+  link->encoding = true;
+  resume_link(link);
+}
+
+bool
+oc_collection_batch_set_buffer(oc_separate_response_t *handle)
+{
+  oc_batch_link_t *link = NULL;
+  oc_batch_response_t *batch = find_batch_link(handle, &link);
+  if (!batch) {
+    return false;
+  }
+  open_batch_link(link);
+  return true;
+}
+
+int
+oc_collection_batch_send(oc_separate_response_t *handle)
+{
+  oc_batch_link_t *link = NULL;
+  oc_batch_response_t *batch = find_batch_link(handle, &link);
+  if (!batch) {
+    return -1;
+  }
+  /* Another link may still be encoding; it carries on after this one. */
+  oc_batch_link_t *resume = (open_link != link) ? open_link : NULL;
+  if (!link->encoding) {
+    open_batch_link(link);
+  }
+  suspend_open_link();
+
+  uint8_t *buffer = handle->buffer;
+  size_t rep_end = cbor_encoder_get_buffer_size(&link->map, buffer);
+  if (rep_end == link->rep_offset) {
+    CborEncoder empty;
+    link->err |= cbor_encoder_create_map(&link->map, &empty,
+                                         CborIndefiniteLength);
+    link->err |= cbor_encoder_close_container(&link->map, &empty);
+    rep_end = cbor_encoder_get_buffer_size(&link->map, buffer);
+  }
+  link->err |= cbor_encoder_close_container(&link->encoder, &link->map);
+
+  int length = 0;
+  if (link->err == CborNoError) {
+    g_err = CborNoError;
+    oc_rep_encode_raw(&batch->links, buffer,
+                      cbor_encoder_get_buffer_size(&link->encoder, buffer));
+    if (g_err != CborNoError) {
+      OC_WRN("batch link %s does not fit the batch response",
+             oc_string(link->href));
+    }
+    /* Make the representation available to any requests that were
+     * registered directly against this handle in the meantime.
+     */
+    length = (int)(rep_end - link->rep_offset);
+    memmove(buffer, buffer + link->rep_offset, (size_t)length);
+  } else {
+    OC_WRN("could not encode batch link %s", oc_string(link->href));
+  }
+
+  free_batch_link(batch, link);
+  if (oc_list_length(batch->pending) == 0) {
+    oc_remove_delayed_callback(batch, batch_response_timeout);
+    finish_batch_response(batch);
+  }
+  if (resume) {
+    resume_link(resume);
+  }
+  return length;
+}
+
+void
+oc_collection_free_batch_responses(void)
+{
+  oc_batch_response_t *batch;
+  while ((batch = oc_list_head(batch_responses)) != NULL) {
+    oc_remove_delayed_callback(batch, batch_response_timeout);
+    oc_batch_link_t *link;
+    while ((link = oc_list_head(batch->pending)) != NULL) {
+      link->handle->active = 0;
+#ifdef OC_DYNAMIC_ALLOCATION
+      free(link->handle->buffer);
+      link->handle->buffer = NULL;
+#endif /* OC_DYNAMIC_ALLOCATION */
+      free_batch_link(batch, link);
+    }
+    coap_separate_t *request;
+    while ((request = oc_list_head(batch->response.requests)) != NULL) {
+      coap_separate_clear(&batch->response, request);
+    }
+#ifdef OC_DYNAMIC_ALLOCATION
+    free(batch->response.buffer);
+#endif /* OC_DYNAMIC_ALLOCATION */
+    free_batch_response(batch);
+  }
 }
 
 bool
@@ -409,6 +887,7 @@ oc_handle_collection_request(oc_method_t method, oc_request_t *request,
   int pcode = oc_status_code(OC_STATUS_BAD_REQUEST);
   oc_collection_t *collection = (oc_collection_t *)request->resource;
   oc_link_t *link = oc_list_head(collection->links);
+  oc_batch_response_t *batch = NULL;
   switch (iface_mask) {
 #ifdef OC_COLLECTIONS_IF_CREATE
   case OC_IF_CREATE: {
@@ -740,6 +1219,19 @@ oc_handle_collection_request(oc_method_t method, oc_request_t *request,
     rest_request.response = &response;
     rest_request.origin = request->origin;
 
+    /* In async batch mode the payload is assembled in a buffer of its own so
+     * that it can outlive this request if any link handler defers.
+     */
+    if (method == OC_GET && !notify_resource &&
+        collection->batch_timeout_seconds > 0 && request->origin &&
+        !(request->origin->flags & MULTICAST)) {
+      batch = alloc_batch_response();
+      if (batch) {
+        oc_rep_new(batch->response.buffer,
+                   request->response->response_buffer->buffer_size);
+      }
+    }
+
     oc_rep_start_links_array();
     memcpy(&encoder, &g_encoder, sizeof(CborEncoder));
     if (method == OC_GET || method == OC_DELETE) {
@@ -769,7 +1261,9 @@ oc_handle_collection_request(oc_method_t method, oc_request_t *request,
           pay = pay->next;
         }
       process_request:
-        link = oc_list_head(collection->links);
+        link = notify_resource
+                 ? get_link_by_resource(collection, notify_resource, NULL)
+                 : oc_list_head(collection->links);
         while (link != NULL) {
           if (link->resource &&
               (!notify_resource == !(link->resource == notify_resource))) {
@@ -844,6 +1338,17 @@ oc_handle_collection_request(oc_method_t method, oc_request_t *request,
                 }
               }
 
+              if (batch && response.separate_response) {
+                bool deferred =
+                  defer_batch_link(batch, link->resource,
+                                   response.separate_response);
+                response.separate_response = NULL;
+                if (deferred) {
+                  memcpy(&links_array, &prev_link, sizeof(CborEncoder));
+                  goto next;
+                }
+              }
+
               if (method_not_found ||
                   (href && oc_string_len(*href) > 0 &&
                    response_buffer.code >=
@@ -874,7 +1379,9 @@ oc_handle_collection_request(oc_method_t method, oc_request_t *request,
             }
           }
         next:
-          link = link->next;
+          link = notify_resource
+                   ? get_link_by_resource(collection, notify_resource, link)
+                   : link->next;
         }
         if (get_delete) {
           goto processed_request;
@@ -888,6 +1395,20 @@ oc_handle_collection_request(oc_method_t method, oc_request_t *request,
     }
   processed_request:
     memcpy(&g_encoder, &encoder, sizeof(CborEncoder));
+    if (batch && oc_list_length(batch->pending) > 0) {
+      /* Hand the partially assembled payload over to the batch response and
+       * complete it as the deferred links respond.
+       */
+      memcpy(&batch->encoder, &g_encoder, sizeof(CborEncoder));
+      memcpy(&batch->links, &links_array, sizeof(CborEncoder));
+      batch->response.active = 1;
+      request->response->separate_response = &batch->response;
+      request->response->response_buffer->response_length = 0;
+      request->response->response_buffer->code = oc_status_code(OC_STATUS_OK);
+      oc_set_delayed_callback(batch, batch_response_timeout,
+                              collection->batch_timeout_seconds);
+      return true;
+    }
     oc_rep_end_links_array();
   } break;
   default:
@@ -898,6 +1419,17 @@ oc_handle_collection_request(oc_method_t method, oc_request_t *request,
 
   int size = oc_rep_get_encoded_payload_size();
 
+  if (batch) {
+    if (size > 0) {
+      memcpy(request->response->response_buffer->buffer,
+             batch->response.buffer, (size_t)size);
+    }
+#ifdef OC_DYNAMIC_ALLOCATION
+    free(batch->response.buffer);
+#endif /* OC_DYNAMIC_ALLOCATION */
+    free_batch_response(batch);
+  }
+
   if (ecode < oc_status_code(OC_STATUS_BAD_REQUEST) &&
       pcode < oc_status_code(OC_STATUS_BAD_REQUEST)) {
     switch (method) {
@@ -34,11 +34,30 @@
 #include "port/oc_assert.h"
 #include <stdarg.h>
 
+#ifndef OC_MAX_CORE_CACHED_REP_SIZE
+#define OC_MAX_CORE_CACHED_REP_SIZE (256)
+#endif /* !OC_MAX_CORE_CACHED_REP_SIZE */
+
+/* Encoded properties of a core resource for one interface. Larger encodings
+ * are not cached and are encoded for every request.
+ */
+typedef struct oc_cached_rep_s
+{
+  size_t size;
+  uint8_t data[OC_MAX_CORE_CACHED_REP_SIZE];
+} oc_cached_rep_t;
+
 #ifdef OC_DYNAMIC_ALLOCATION
 #include "oc_endpoint.h"
 #include <stdlib.h>
 static oc_resource_t *core_resources = NULL;
 static oc_device_info_t *oc_device_info = NULL;
+/* Encoded properties of oic.wk.d (per device) and oic.wk.p for the oic.if.r
+ * and oic.if.baseline interfaces, replayed into every response. Static
+ * builds do not reserve memory for them and encode every response.
+ */
+static oc_cached_rep_t *device_reps = NULL;
+static oc_cached_rep_t platform_reps[2];
 #else  /* OC_DYNAMIC_ALLOCATION */
 static oc_resource_t core_resources[1 + OCF_D * OC_MAX_NUM_DEVICES];
 static oc_device_info_t oc_device_info[OC_MAX_NUM_DEVICES];
@@ -56,6 +75,50 @@ static size_t device_count = 0;
 /* Number of characters of OC_NAME_CON_RES */
 #define OC_NAMELEN_CON_RES 6
 
+static void
+free_all_cached_reps(void)
+{
+  size_t i;
+  for (i = 0; i < device_count; i++) {
+    oc_core_invalidate_device_reps(i);
+  }
+}
+
+static oc_cached_rep_t *
+get_device_rep(size_t device, oc_interface_mask_t iface_mask)
+{
+#ifdef OC_DYNAMIC_ALLOCATION
+  return &device_reps[2 * device + ((iface_mask == OC_IF_BASELINE) ? 1 : 0)];
+#else  /* OC_DYNAMIC_ALLOCATION */
+  (void)device;
+  (void)iface_mask;
+  return NULL;
+#endif /* !OC_DYNAMIC_ALLOCATION */
+}
+
+static oc_cached_rep_t *
+get_platform_rep(oc_interface_mask_t iface_mask)
+{
+#ifdef OC_DYNAMIC_ALLOCATION
+  return &platform_reps[(iface_mask == OC_IF_BASELINE) ? 1 : 0];
+#else  /* OC_DYNAMIC_ALLOCATION */
+  (void)iface_mask;
+  return NULL;
+#endif /* !OC_DYNAMIC_ALLOCATION */
+}
+
+static void
+store_cached_rep(oc_cached_rep_t *rep, const uint8_t *start,
+                 const uint8_t *end)
+{
+  if (!start || !end || end <= start ||
+      (size_t)(end - start) > sizeof(rep->data)) {
+    return;
+  }
+  memcpy(rep->data, start, (size_t)(end - start));
+  rep->size = (size_t)(end - start);
+}
+
 void
 oc_core_init(void)
 {
@@ -91,6 +154,11 @@ oc_core_shutdown(void)
   size_t i;
   if (oc_string_len(oc_platform_info.mfg_name))
     oc_free_string(&(oc_platform_info.mfg_name));
+  oc_core_invalidate_platform_reps();
+#ifdef OC_DYNAMIC_ALLOCATION
+  free(device_reps);
+  device_reps = NULL;
+#endif /* OC_DYNAMIC_ALLOCATION */
 
 #ifdef OC_DYNAMIC_ALLOCATION
   if (oc_device_info) {
@@ -118,6 +186,8 @@ oc_core_shutdown(void)
   }
 #endif /* OC_DYNAMIC_ALLOCATION */
   device_count = 0;
+
+  oc_introspection_free_cache();
 }
 
 void
@@ -154,31 +224,52 @@ oc_core_encode_interfaces_mask(CborEncoder *parent,
 }
 
 static void
-oc_core_device_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
-                       void *data)
+oc_core_encode_device_properties(oc_request_t *request,
+                                 oc_interface_mask_t iface_mask, size_t device)
 {
-  (void)data;
-  size_t device = request->resource->device;
-  oc_rep_start_root_object();
-
   char di[OC_UUID_LEN], piid[OC_UUID_LEN];
   oc_uuid_to_str(&oc_device_info[device].di, di, OC_UUID_LEN);
   if (request->origin && request->origin->version != OIC_VER_1_1_0) {
     oc_uuid_to_str(&oc_device_info[device].piid, piid, OC_UUID_LEN);
   }
 
+  if (iface_mask == OC_IF_BASELINE) {
+    oc_process_baseline_interface(request->resource);
+  }
+  oc_rep_set_text_string(root, di, di);
+  if (request->origin && request->origin->version != OIC_VER_1_1_0) {
+    oc_rep_set_text_string(root, piid, piid);
+  }
+  oc_rep_set_text_string(root, n, oc_string(oc_device_info[device].name));
+  oc_rep_set_text_string(root, icv, oc_string(oc_device_info[device].icv));
+  oc_rep_set_text_string(root, dmv, oc_string(oc_device_info[device].dmv));
+}
+
+static void
+oc_core_device_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
+                       void *data)
+{
+  (void)data;
+  size_t device = request->resource->device;
+  oc_rep_start_root_object();
+
   switch (iface_mask) {
   case OC_IF_BASELINE:
-    oc_process_baseline_interface(request->resource);
-  /* fall through */
   case OC_IF_R: {
-    oc_rep_set_text_string(root, di, di);
+    /* Responses to OIC 1.1 clients omit piid and are not cached */
+    oc_cached_rep_t *rep = NULL;
     if (request->origin && request->origin->version != OIC_VER_1_1_0) {
-      oc_rep_set_text_string(root, piid, piid);
+      rep = get_device_rep(device, iface_mask);
+    }
+    if (rep && rep->size > 0) {
+      oc_rep_encode_raw(&root_map, rep->data, rep->size);
+    } else {
+      const uint8_t *start = oc_rep_get_encoder_pos(&root_map);
+      oc_core_encode_device_properties(request, iface_mask, device);
+      if (rep) {
+        store_cached_rep(rep, start, oc_rep_get_encoder_pos(&root_map));
+      }
     }
-    oc_rep_set_text_string(root, n, oc_string(oc_device_info[device].name));
-    oc_rep_set_text_string(root, icv, oc_string(oc_device_info[device].icv));
-    oc_rep_set_text_string(root, dmv, oc_string(oc_device_info[device].dmv));
     if (oc_device_info[device].add_device_cb) {
       oc_device_info[device].add_device_cb(oc_device_info[device].data);
     }
@@ -235,6 +326,7 @@ oc_core_con_handler_post(oc_request_t *request, oc_interface_mask_t iface_mask,
       oc_free_string(&oc_device_info[device].name);
       oc_new_string(&oc_device_info[device].name, oc_string(rep->value.string),
                     oc_string_len(rep->value.string));
+      oc_core_invalidate_device_reps(device);
       oc_rep_start_root_object();
       oc_rep_set_text_string(root, n, oc_string(oc_device_info[device].name));
       oc_rep_end_root_object();
@@ -276,6 +368,7 @@ void
 oc_set_con_res_announced(bool announce)
 {
   announce_con_res = announce;
+  free_all_cached_reps();
 }
 
 oc_device_info_t *
@@ -308,8 +401,19 @@ oc_core_add_new_device(const char *uri, const char *rt, const char *name,
   }
   memset(&oc_device_info[device_count], 0, sizeof(oc_device_info_t));
 
+  device_reps = (oc_cached_rep_t *)realloc(
+    device_reps, 2 * (device_count + 1) * sizeof(oc_cached_rep_t));
+
+  if (!device_reps) {
+    oc_abort("Insufficient memory");
+  }
+  device_reps[2 * device_count].size = 0;
+  device_reps[2 * device_count + 1].size = 0;
+
 #endif /* OC_DYNAMIC_ALLOCATION */
 
+  free_all_cached_reps();
+
   oc_gen_uuid(&oc_device_info[device_count].di);
 
   /* Construct device resource */
@@ -385,6 +489,7 @@ oc_device_bind_rt(size_t device_index, const char *rt)
     }
   }
   oc_free_string_array(&types);
+  oc_core_invalidate_device_reps(device_index);
 }
 
 void
@@ -400,16 +505,25 @@ oc_core_platform_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
   (void)data;
   oc_rep_start_root_object();
 
-  char pi[OC_UUID_LEN];
-  oc_uuid_to_str(&oc_platform_info.pi, pi, OC_UUID_LEN);
-
   switch (iface_mask) {
   case OC_IF_BASELINE:
-    oc_process_baseline_interface(request->resource);
-  /* fall through */
   case OC_IF_R: {
-    oc_rep_set_text_string(root, pi, pi);
-    oc_rep_set_text_string(root, mnmn, oc_string(oc_platform_info.mfg_name));
+    oc_cached_rep_t *rep = get_platform_rep(iface_mask);
+    if (rep && rep->size > 0) {
+      oc_rep_encode_raw(&root_map, rep->data, rep->size);
+    } else {
+      const uint8_t *start = oc_rep_get_encoder_pos(&root_map);
+      char pi[OC_UUID_LEN];
+      oc_uuid_to_str(&oc_platform_info.pi, pi, OC_UUID_LEN);
+      if (iface_mask == OC_IF_BASELINE) {
+        oc_process_baseline_interface(request->resource);
+      }
+      oc_rep_set_text_string(root, pi, pi);
+      oc_rep_set_text_string(root, mnmn, oc_string(oc_platform_info.mfg_name));
+      if (rep) {
+        store_cached_rep(rep, start, oc_rep_get_encoder_pos(&root_map));
+      }
+    }
     if (oc_platform_info.init_platform_cb) {
       oc_platform_info.init_platform_cb(oc_platform_info.data);
     }
@@ -438,6 +552,7 @@ oc_core_init_platform(const char *mfg_name, oc_core_init_platform_cb_t init_cb,
   oc_gen_uuid(&oc_platform_info.pi);
 
   oc_new_string(&oc_platform_info.mfg_name, mfg_name, strlen(mfg_name));
+  oc_core_invalidate_platform_reps();
   oc_platform_info.init_platform_cb = init_cb;
   oc_platform_info.data = data;
 
@@ -508,6 +623,28 @@ oc_core_get_device_info(size_t device)
   return &oc_device_info[device];
 }
 
+void
+oc_core_invalidate_device_reps(size_t device)
+{
+#ifdef OC_DYNAMIC_ALLOCATION
+  if (device_reps && device < device_count) {
+    device_reps[2 * device].size = 0;
+    device_reps[2 * device + 1].size = 0;
+  }
+#else  /* OC_DYNAMIC_ALLOCATION */
+  (void)device;
+#endif /* !OC_DYNAMIC_ALLOCATION */
+}
+
+void
+oc_core_invalidate_platform_reps(void)
+{
+#ifdef OC_DYNAMIC_ALLOCATION
+  platform_reps[0].size = 0;
+  platform_reps[1].size = 0;
+#endif /* OC_DYNAMIC_ALLOCATION */
+}
+
 oc_platform_info_t *
 oc_core_get_platform_info(void)
 {
@@ -627,10 +764,11 @@ oc_filter_resource_by_rt(oc_resource_t *resource, oc_request_t *request)
   bool match = true, more_query_params = false;
   char *rt = NULL;
   int rt_len = -1;
-  oc_init_query_iterator();
+  oc_query_iterator_t iterator;
+  oc_query_iterator_init(&iterator, request);
   do {
     more_query_params =
-      oc_iterate_query_get_values(request, "rt", &rt, &rt_len);
+      oc_query_iterator_get_values(&iterator, "rt", &rt, &rt_len);
     if (rt_len > 0) {
       match = false;
       int i;
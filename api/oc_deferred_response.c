@@ -0,0 +1,209 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "oc_config.h"
+
+#ifdef OC_SERVER
+#include "api/oc_deferred_response_internal.h"
+#include "messaging/coap/oc_coap.h"
+#include "oc_api.h"
+#include "oc_signal_event_loop.h"
+#include "port/oc_log.h"
+#include "port/oc_network_events_mutex.h"
+#include "util/oc_memb.h"
+#include <string.h>
+
+#ifdef OC_DYNAMIC_ALLOCATION
+#include <stdlib.h>
+#endif /* OC_DYNAMIC_ALLOCATION */
+
+/* Each handle embeds a separate response, which in static builds carries a
+ * full payload buffer, so only a few requests can be deferred at once. */
+#ifndef OC_MAX_DEFERRED_REQUESTS
+#define OC_MAX_DEFERRED_REQUESTS (2)
+#endif /* !OC_MAX_DEFERRED_REQUESTS */
+
+struct oc_deferred_request_s
+{
+  struct oc_deferred_request_s *next;
+  oc_separate_response_t separate;
+  oc_status_t code;
+  size_t payload_len;
+#ifdef OC_DYNAMIC_ALLOCATION
+  uint8_t *payload;
+#else  /* OC_DYNAMIC_ALLOCATION */
+  uint8_t payload[OC_MAX_APP_DATA_SIZE];
+#endif /* !OC_DYNAMIC_ALLOCATION */
+};
+
+OC_MEMB(deferred_requests_s, oc_deferred_request_t, OC_MAX_DEFERRED_REQUESTS);
+
+/* Completed handles are pushed by any thread onto a lock-free stack and
+ * drained, oldest first, by the oc_deferred_responses process.
+ */
+static oc_deferred_request_t *completed_head;
+
+#if defined(__GNUC__) || defined(__clang__)
+static void
+push_completed(oc_deferred_request_t *handle)
+{
+  oc_deferred_request_t *head =
+    __atomic_load_n(&completed_head, __ATOMIC_RELAXED);
+  do {
+    handle->next = head;
+  } while (!__atomic_compare_exchange_n(&completed_head, &head, handle, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+static oc_deferred_request_t *
+take_completed(void)
+{
+  return __atomic_exchange_n(&completed_head, NULL, __ATOMIC_ACQUIRE);
+}
+#else /* __GNUC__ || __clang__ */
+static void
+push_completed(oc_deferred_request_t *handle)
+{
+  oc_network_event_handler_mutex_lock();
+  handle->next = completed_head;
+  completed_head = handle;
+  oc_network_event_handler_mutex_unlock();
+}
+
+static oc_deferred_request_t *
+take_completed(void)
+{
+  oc_network_event_handler_mutex_lock();
+  oc_deferred_request_t *head = completed_head;
+  completed_head = NULL;
+  oc_network_event_handler_mutex_unlock();
+  return head;
+}
+#endif /* !__GNUC__ && !__clang__ */
+
+static void
+free_deferred_request(oc_deferred_request_t *handle)
+{
+#ifdef OC_DYNAMIC_ALLOCATION
+  free(handle->payload);
+#endif /* OC_DYNAMIC_ALLOCATION */
+  oc_memb_free(&deferred_requests_s, handle);
+}
+
+static void
+send_deferred_response(oc_deferred_request_t *handle)
+{
+#ifdef OC_DYNAMIC_ALLOCATION
+  /* The separate response never got a buffer if the request could not be
+   * registered; there is nobody left to answer. */
+  if (!handle->separate.buffer) {
+    OC_WRN("deferred request was never accepted, dropping its response");
+    free_deferred_request(handle);
+    return;
+  }
+#endif /* OC_DYNAMIC_ALLOCATION */
+  oc_set_separate_response_buffer(&handle->separate);
+  if (handle->payload_len > 0) {
+    oc_rep_encode_raw(&g_encoder, handle->payload, handle->payload_len);
+  }
+  oc_send_separate_response(&handle->separate, handle->code);
+  free_deferred_request(handle);
+}
+
+static void
+process_completed(void)
+{
+  oc_deferred_request_t *handle = take_completed(), *ordered = NULL, *next;
+
+  while (handle) {
+    next = handle->next;
+    handle->next = ordered;
+    ordered = handle;
+    handle = next;
+  }
+  while (ordered) {
+    next = ordered->next;
+    send_deferred_response(ordered);
+    ordered = next;
+  }
+}
+
+OC_PROCESS(oc_deferred_responses, "Deferred responses");
+OC_PROCESS_THREAD(oc_deferred_responses, ev, data)
+{
+  (void)data;
+  OC_PROCESS_POLLHANDLER(process_completed());
+  OC_PROCESS_BEGIN();
+  while (oc_process_is_running(&(oc_deferred_responses))) {
+    OC_PROCESS_YIELD();
+  }
+  oc_deferred_request_t *handle = take_completed(), *next;
+  while (handle) {
+    next = handle->next;
+    free_deferred_request(handle);
+    handle = next;
+  }
+  OC_PROCESS_END();
+}
+
+oc_deferred_request_t *
+oc_request_defer(oc_request_t *request)
+{
+  if (!request || !oc_process_is_running(&(oc_deferred_responses))) {
+    return NULL;
+  }
+  oc_deferred_request_t *handle =
+    (oc_deferred_request_t *)oc_memb_alloc(&deferred_requests_s);
+  if (!handle) {
+    OC_WRN("insufficient memory to defer request");
+    return NULL;
+  }
+  oc_indicate_separate_response(request, &handle->separate);
+  return handle;
+}
+
+int
+oc_request_complete(oc_deferred_request_t *handle, oc_status_t code,
+                    const uint8_t *payload, size_t len)
+{
+  if (!handle || (len > 0 && !payload) ||
+      len > (size_t)OC_MAX_APP_DATA_SIZE) {
+    return -1;
+  }
+#ifdef OC_DYNAMIC_ALLOCATION
+  if (len > 0) {
+    handle->payload = (uint8_t *)malloc(len);
+    if (!handle->payload) {
+      OC_WRN("insufficient memory for deferred response payload");
+      code = OC_STATUS_INTERNAL_SERVER_ERROR;
+      len = 0;
+    }
+  }
+#endif /* OC_DYNAMIC_ALLOCATION */
+  if (len > 0) {
+    memcpy(handle->payload, payload, len);
+  }
+  handle->payload_len = len;
+  handle->code = code;
+
+  push_completed(handle);
+  oc_process_poll(&(oc_deferred_responses));
+  _oc_signal_event_loop();
+  return 0;
+}
+#else  /* OC_SERVER */
+typedef int dummy_declaration;
+#endif /* !OC_SERVER */
@@ -0,0 +1,32 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#ifndef OC_DEFERRED_RESPONSE_INTERNAL_H
+#define OC_DEFERRED_RESPONSE_INTERNAL_H
+
+#include "util/oc_process.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OC_PROCESS_NAME(oc_deferred_responses);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OC_DEFERRED_RESPONSE_INTERNAL_H */
@@ -28,6 +28,9 @@
 
 #include "oc_core_res.h"
 #include "oc_endpoint.h"
+#include "port/oc_clock.h"
+#include "port/oc_random.h"
+#include "util/oc_memb.h"
 
 static bool
 filter_resource(oc_resource_t *resource, oc_request_t *request,
@@ -461,12 +464,330 @@ oc_core_1_1_discovery_handler(oc_request_t *request,
 }
 #endif /* OC_SPEC_VER_OIC */
 
+#ifdef OC_SERVER
+/* Every delayed response holds a full separate response buffer, so static
+ * builds only reserve a pool for them when the port configuration defines
+ * OC_MAX_DISCOVERY_RESPONSES.
+ */
+#if defined(OC_DYNAMIC_ALLOCATION) && !defined(OC_MAX_DISCOVERY_RESPONSES)
+#define OC_MAX_DISCOVERY_RESPONSES (16)
+#endif /* OC_DYNAMIC_ALLOCATION && !OC_MAX_DISCOVERY_RESPONSES */
+
+#ifndef OC_MAX_DISCOVERY_CLIENTS
+#define OC_MAX_DISCOVERY_CLIENTS (16)
+#endif /* !OC_MAX_DISCOVERY_CLIENTS */
+
+#ifdef OC_MAX_DISCOVERY_RESPONSES
+/* A response to a multicast discovery request that is held back for a
+ * random delay
+ */
+typedef struct oc_discovery_response_s
+{
+  struct oc_discovery_response_s *next;
+  oc_separate_response_t handle;
+  size_t device;
+  oc_endpoint_t origin;
+  oc_string_t query;
+  oc_interface_mask_t iface_mask;
+} oc_discovery_response_t;
+#endif /* OC_MAX_DISCOVERY_RESPONSES */
+
+/* Recent multicast discovery activity of a client */
+typedef struct oc_discovery_client_s
+{
+  struct oc_discovery_client_s *next;
+  size_t device;
+  oc_endpoint_t endpoint;
+  oc_clock_time_t window_start;
+  uint16_t responses;
+  uint32_t query_hash;
+  oc_clock_time_t query_time;
+} oc_discovery_client_t;
+
+#ifdef OC_MAX_DISCOVERY_RESPONSES
+OC_LIST(discovery_responses);
+OC_MEMB(discovery_responses_s, oc_discovery_response_t,
+        OC_MAX_DISCOVERY_RESPONSES);
+#endif /* OC_MAX_DISCOVERY_RESPONSES */
+OC_LIST(discovery_clients);
+#ifdef OC_DYNAMIC_ALLOCATION
+OC_MEMB_FIXED(discovery_clients_s, oc_discovery_client_t,
+              OC_MAX_DISCOVERY_CLIENTS);
+#else  /* OC_DYNAMIC_ALLOCATION */
+OC_MEMB(discovery_clients_s, oc_discovery_client_t, OC_MAX_DISCOVERY_CLIENTS);
+#endif /* !OC_DYNAMIC_ALLOCATION */
+
+static uint32_t discovery_leisure_ms = 0;
+static uint16_t discovery_rate_limit = 0;
+static uint16_t discovery_rate_window = 0;
+static uint32_t discovery_suppression_ms = 0;
+static bool sending_delayed_response = false;
+
+void
+oc_set_mcast_discovery_leisure(uint32_t leisure_ms)
+{
+  discovery_leisure_ms = leisure_ms;
+}
+
+void
+oc_set_mcast_discovery_rate_limit(uint16_t max_responses,
+                                  uint16_t window_seconds)
+{
+  discovery_rate_limit = max_responses;
+  discovery_rate_window = window_seconds;
+}
+
+void
+oc_set_mcast_discovery_suppression(uint32_t window_ms)
+{
+  discovery_suppression_ms = window_ms;
+}
+
+static uint32_t
+discovery_query_hash(oc_request_t *request, oc_interface_mask_t iface_mask)
+{
+  uint32_t hash = 2166136261u ^ (uint32_t)iface_mask;
+  size_t i;
+  for (i = 0; i < request->query_len; i++) {
+    hash ^= (uint8_t)request->query[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static oc_discovery_client_t *
+get_discovery_client(size_t device, oc_endpoint_t *endpoint,
+                     oc_clock_time_t now)
+{
+  oc_clock_time_t lifetime =
+    (oc_clock_time_t)discovery_rate_window * OC_CLOCK_SECOND;
+  oc_clock_time_t suppression =
+    (oc_clock_time_t)discovery_suppression_ms * OC_CLOCK_SECOND / 1000;
+  if (suppression > lifetime) {
+    lifetime = suppression;
+  }
+
+  oc_discovery_client_t *client = oc_list_head(discovery_clients), *next;
+  while (client != NULL) {
+    next = client->next;
+    if (client->device == device &&
+        oc_endpoint_compare_address(&client->endpoint, endpoint) == 0) {
+      return client;
+    }
+    /* Forget clients that have been quiet for longer than any window */
+    if (now - client->window_start > lifetime &&
+        now - client->query_time > lifetime) {
+      oc_list_remove(discovery_clients, client);
+      oc_memb_free(&discovery_clients_s, client);
+    }
+    client = next;
+  }
+
+  client = (oc_discovery_client_t *)oc_memb_alloc(&discovery_clients_s);
+  if (client) {
+    client->device = device;
+    memcpy(&client->endpoint, endpoint, sizeof(oc_endpoint_t));
+    client->endpoint.next = NULL;
+    client->window_start = now;
+    client->responses = 0;
+    client->query_hash = 0;
+    client->query_time = 0;
+    oc_list_add(discovery_clients, client);
+  }
+  return client;
+}
+
+/* Returns true if a multicast discovery request must not be answered, either
+ * because the same client sent the same query within the suppression window
+ * or because it exhausted its responses for the rate limiting window.
+ */
+static bool
+suppress_discovery_request(oc_request_t *request,
+                           oc_interface_mask_t iface_mask)
+{
+  if (discovery_suppression_ms == 0 &&
+      (discovery_rate_limit == 0 || discovery_rate_window == 0)) {
+    return false;
+  }
+  oc_clock_time_t now = oc_clock_time();
+  oc_discovery_client_t *client =
+    get_discovery_client(request->resource->device, request->origin, now);
+  if (!client) {
+    /* Too many clients to track, answer without limiting */
+    return false;
+  }
+
+  if (discovery_suppression_ms > 0) {
+    uint32_t hash = discovery_query_hash(request, iface_mask);
+    bool duplicate =
+      (client->query_time != 0 && client->query_hash == hash &&
+       now - client->query_time <= (oc_clock_time_t)discovery_suppression_ms *
+                                      OC_CLOCK_SECOND / 1000);
+    client->query_hash = hash;
+    client->query_time = now;
+    if (duplicate) {
+      OC_DBG("suppressing duplicate multicast discovery request");
+      return true;
+    }
+  }
+
+  if (discovery_rate_limit > 0 && discovery_rate_window > 0) {
+    if (now - client->window_start >
+        (oc_clock_time_t)discovery_rate_window * OC_CLOCK_SECOND) {
+      client->window_start = now;
+      client->responses = 0;
+    }
+    if (client->responses >= discovery_rate_limit) {
+      OC_DBG("multicast discovery rate limit reached for client");
+      return true;
+    }
+    client->responses++;
+  }
+
+  return false;
+}
+
+#ifdef OC_MAX_DISCOVERY_RESPONSES
+static void
+free_discovery_response(oc_discovery_response_t *response)
+{
+  coap_separate_t *cur;
+  while ((cur = oc_list_head(response->handle.requests)) != NULL) {
+    coap_separate_clear(&response->handle, cur);
+  }
+#ifdef OC_DYNAMIC_ALLOCATION
+  free(response->handle.buffer);
+  response->handle.buffer = NULL;
+#endif /* OC_DYNAMIC_ALLOCATION */
+  response->handle.active = 0;
+  if (oc_string_len(response->query) > 0) {
+    oc_free_string(&response->query);
+  }
+  oc_list_remove(discovery_responses, response);
+  oc_memb_free(&discovery_responses_s, response);
+}
+
+static void oc_core_discovery_handler(oc_request_t *request,
+                                      oc_interface_mask_t iface_mask,
+                                      void *data);
+
+static oc_event_callback_retval_t
+send_delayed_discovery_response(void *data)
+{
+  oc_discovery_response_t *response = (oc_discovery_response_t *)data;
+
+  if (response->handle.active) {
+    oc_response_buffer_t response_buffer;
+    memset(&response_buffer, 0, sizeof(oc_response_buffer_t));
+    oc_response_t response_obj;
+    memset(&response_obj, 0, sizeof(oc_response_t));
+    response_obj.response_buffer = &response_buffer;
+    oc_request_t request;
+    memset(&request, 0, sizeof(oc_request_t));
+    request.origin = &response->origin;
+    request.resource = oc_core_get_resource_by_index(OCF_RES, response->device);
+    request.query = oc_string(response->query);
+    request.query_len = oc_string_len(response->query);
+    request.response = &response_obj;
+
+    oc_set_separate_response_buffer(&response->handle);
+    sending_delayed_response = true;
+    oc_core_discovery_handler(&request, response->iface_mask, NULL);
+    sending_delayed_response = false;
+
+    if (response_buffer.code == oc_status_code(OC_STATUS_OK)) {
+      oc_send_separate_response(&response->handle, OC_STATUS_OK);
+#ifdef OC_DYNAMIC_ALLOCATION
+      response->handle.buffer = NULL;
+#endif /* OC_DYNAMIC_ALLOCATION */
+    }
+  }
+
+  free_discovery_response(response);
+  return OC_EVENT_DONE;
+}
+
+/* Hold back the response to a multicast discovery request for a random
+ * delay within the leisure period (RFC 7252, section 8.2). Returns false if
+ * the response must be sent right away.
+ */
+static bool
+delay_discovery_response(oc_request_t *request, oc_interface_mask_t iface_mask)
+{
+  if (discovery_leisure_ms == 0 ||
+      oc_list_length(discovery_responses) >= OC_MAX_DISCOVERY_RESPONSES) {
+    return false;
+  }
+  oc_discovery_response_t *response =
+    (oc_discovery_response_t *)oc_memb_alloc(&discovery_responses_s);
+  if (!response) {
+    return false;
+  }
+  memset(&response->handle, 0, sizeof(oc_separate_response_t));
+  response->device = request->resource->device;
+  memcpy(&response->origin, request->origin, sizeof(oc_endpoint_t));
+  response->origin.next = NULL;
+  memset(&response->query, 0, sizeof(oc_string_t));
+  if (request->query_len > 0) {
+    oc_new_string(&response->query, request->query, request->query_len);
+  }
+  response->iface_mask = iface_mask;
+  oc_list_add(discovery_responses, response);
+
+  oc_clock_time_t leisure =
+    (oc_clock_time_t)discovery_leisure_ms * OC_CLOCK_SECOND / 1000;
+  oc_clock_time_t delay = (oc_clock_time_t)oc_random_value() % (leisure + 1);
+  oc_indicate_separate_response(request, &response->handle);
+  oc_ri_add_timed_event_callback_ticks(response,
+                                       send_delayed_discovery_response, delay);
+  return true;
+}
+#endif /* OC_MAX_DISCOVERY_RESPONSES */
+
+void
+oc_discovery_free_delayed_responses(void)
+{
+#ifdef OC_MAX_DISCOVERY_RESPONSES
+  oc_discovery_response_t *response;
+  while ((response = oc_list_head(discovery_responses)) != NULL) {
+    oc_ri_remove_timed_event_callback(response,
+                                      send_delayed_discovery_response);
+    free_discovery_response(response);
+  }
+#endif /* OC_MAX_DISCOVERY_RESPONSES */
+  oc_discovery_client_t *client;
+  while ((client = oc_list_pop(discovery_clients)) != NULL) {
+    oc_memb_free(&discovery_clients_s, client);
+  }
+}
+#else  /* OC_SERVER */
+void
+oc_discovery_free_delayed_responses(void)
+{
+}
+#endif /* !OC_SERVER */
+
 static void
 oc_core_discovery_handler(oc_request_t *request, oc_interface_mask_t iface_mask,
                           void *data)
 {
   (void)data;
 
+#ifdef OC_SERVER
+  if (!sending_delayed_response && request->origin &&
+      (request->origin->flags & MULTICAST)) {
+    if (suppress_discovery_request(request, iface_mask)) {
+      request->response->response_buffer->code = OC_IGNORE;
+      return;
+    }
+#ifdef OC_MAX_DISCOVERY_RESPONSES
+    if (delay_discovery_response(request, iface_mask)) {
+      return;
+    }
+#endif /* OC_MAX_DISCOVERY_RESPONSES */
+  }
+#endif /* OC_SERVER */
+
 #ifdef OC_SPEC_VER_OIC
   if (request->origin && request->origin->version == OIC_VER_1_1_0) {
     oc_core_1_1_discovery_handler(request, iface_mask, data);
@@ -521,42 +842,375 @@ oc_create_discovery_resource(int resource_idx, size_t device)
 }
 
 #ifdef OC_CLIENT
-oc_discovery_flags_t
-oc_ri_process_discovery_payload(uint8_t *payload, int len,
-                                oc_client_handler_t client_handler,
-                                oc_endpoint_t *endpoint, void *user_data)
+#ifndef OC_MAX_DISCOVERY_CACHE_DEVICES
+#ifdef OC_DYNAMIC_ALLOCATION
+#define OC_MAX_DISCOVERY_CACHE_DEVICES (32)
+#else /* OC_DYNAMIC_ALLOCATION */
+#define OC_MAX_DISCOVERY_CACHE_DEVICES (4)
+#endif /* !OC_DYNAMIC_ALLOCATION */
+#endif /* !OC_MAX_DISCOVERY_CACHE_DEVICES */
+
+#ifndef OC_MAX_DISCOVERY_CACHE_RESOURCES
+#ifdef OC_DYNAMIC_ALLOCATION
+#define OC_MAX_DISCOVERY_CACHE_RESOURCES (256)
+#else /* OC_DYNAMIC_ALLOCATION */
+#define OC_MAX_DISCOVERY_CACHE_RESOURCES (16)
+#endif /* !OC_DYNAMIC_ALLOCATION */
+#endif /* !OC_MAX_DISCOVERY_CACHE_RESOURCES */
+
+#ifndef OC_DISCOVERY_CACHE_TTL
+#define OC_DISCOVERY_CACHE_TTL (300)
+#endif /* !OC_DISCOVERY_CACHE_TTL */
+
+#ifndef OC_DISCOVERY_CACHE_HREF_LEN
+#define OC_DISCOVERY_CACHE_HREF_LEN (64)
+#endif /* !OC_DISCOVERY_CACHE_HREF_LEN */
+
+#ifndef OC_DISCOVERY_CACHE_MAX_TYPES
+#define OC_DISCOVERY_CACHE_MAX_TYPES (4)
+#endif /* !OC_DISCOVERY_CACHE_MAX_TYPES */
+
+#ifndef OC_DISCOVERY_CACHE_MAX_EPS
+#define OC_DISCOVERY_CACHE_MAX_EPS (4)
+#endif /* !OC_DISCOVERY_CACHE_MAX_EPS */
+
+/* "ocf://" followed by the device UUID */
+#define OC_DISCOVERY_CACHE_ANCHOR_LEN (6 + OC_UUID_LEN)
+
+/* Cached links are copied into fixed buffers, so that a remote payload can
+ * never drain the string or endpoint pools. Links that do not fit are
+ * reported to the application but left uncached.
+ */
+typedef struct oc_discovery_cached_resource_t
 {
-  oc_discovery_handler_t handler = client_handler.discovery;
-  oc_discovery_all_handler_t all_handler = client_handler.discovery_all;
-  bool all = false;
-  if (all_handler) {
-    all = true;
+  struct oc_discovery_cached_resource_t *next;
+  char anchor[OC_DISCOVERY_CACHE_ANCHOR_LEN];
+  char uri[OC_DISCOVERY_CACHE_HREF_LEN];
+  char types[OC_DISCOVERY_CACHE_MAX_TYPES * STRING_ARRAY_ITEM_MAX_LEN];
+  size_t num_types;
+  oc_interface_mask_t iface_mask;
+  oc_resource_properties_t bm;
+  oc_endpoint_t eps[OC_DISCOVERY_CACHE_MAX_EPS];
+  uint32_t hash;
+  bool seen;
+} oc_discovery_cached_resource_t;
+
+typedef struct oc_discovery_cached_device_t
+{
+  struct oc_discovery_cached_device_t *next;
+  OC_LIST_STRUCT(resources);
+  oc_uuid_t di;
+  int family;
+  int payload_len;
+  uint32_t payload_hash;
+  oc_clock_time_t expires;
+  bool updating;
+} oc_discovery_cached_device_t;
+
+OC_LIST(discovery_cache);
+OC_MEMB(discovery_cache_devices_s, oc_discovery_cached_device_t,
+        OC_MAX_DISCOVERY_CACHE_DEVICES);
+OC_MEMB(discovery_cache_resources_s, oc_discovery_cached_resource_t,
+        OC_MAX_DISCOVERY_CACHE_RESOURCES);
+static uint32_t discovery_cache_ttl = OC_DISCOVERY_CACHE_TTL;
+
+void
+oc_set_discovery_cache_ttl(uint32_t ttl_seconds)
+{
+  discovery_cache_ttl = ttl_seconds;
+}
+
+static uint32_t
+discovery_hash(uint32_t hash, const void *data, size_t len)
+{
+  const uint8_t *bytes = (const uint8_t *)data;
+  size_t i;
+  for (i = 0; i < len; i++) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
   }
-  oc_discovery_flags_t ret = OC_CONTINUE_DISCOVERY;
-  oc_string_t *uri = NULL;
-  oc_string_t *anchor = NULL;
-  oc_string_array_t *types = NULL;
-  oc_interface_mask_t iface_mask = 0;
+  return hash;
+}
 
-#ifndef OC_DYNAMIC_ALLOCATION
-  char rep_objects_alloc[OC_MAX_NUM_REP_OBJECTS];
-  oc_rep_t rep_objects_pool[OC_MAX_NUM_REP_OBJECTS];
-  memset(rep_objects_alloc, 0, OC_MAX_NUM_REP_OBJECTS * sizeof(char));
-  memset(rep_objects_pool, 0, OC_MAX_NUM_REP_OBJECTS * sizeof(oc_rep_t));
-  struct oc_memb rep_objects = { sizeof(oc_rep_t), OC_MAX_NUM_REP_OBJECTS,
-                                 rep_objects_alloc, (void *)rep_objects_pool,
-                                 0 };
-#else  /* !OC_DYNAMIC_ALLOCATION */
-  struct oc_memb rep_objects = { sizeof(oc_rep_t), 0, 0, 0, 0 };
-#endif /* OC_DYNAMIC_ALLOCATION */
-  oc_rep_set_pool(&rep_objects);
+static uint32_t
+hash_discovery_link(const char *uri, oc_string_array_t *types,
+                    oc_interface_mask_t iface_mask, oc_resource_properties_t bm,
+                    oc_endpoint_t *eps)
+{
+  uint32_t hash = discovery_hash(2166136261u, uri, strlen(uri) + 1);
+  size_t i;
+  for (i = 0; i < oc_string_array_get_allocated_size(*types); i++) {
+    hash = discovery_hash(hash, oc_string_array_get_item(*types, i),
+                          oc_string_array_get_item_size(*types, i) + 1);
+  }
+  hash = discovery_hash(hash, &iface_mask, sizeof(iface_mask));
+  hash = discovery_hash(hash, &bm, sizeof(bm));
+  while (eps != NULL) {
+    hash = discovery_hash(hash, &eps->flags, sizeof(eps->flags));
+    if (eps->flags & IPV4) {
+      hash = discovery_hash(hash, &eps->addr.ipv4.port,
+                            sizeof(eps->addr.ipv4.port));
+      hash = discovery_hash(hash, eps->addr.ipv4.address,
+                            sizeof(eps->addr.ipv4.address));
+    } else {
+      hash = discovery_hash(hash, &eps->addr.ipv6.port,
+                            sizeof(eps->addr.ipv6.port));
+      hash = discovery_hash(hash, eps->addr.ipv6.address,
+                            sizeof(eps->addr.ipv6.address));
+    }
+    eps = eps->next;
+  }
+  return hash;
+}
 
-  oc_rep_t *links = 0, *rep, *p;
-  int s = oc_parse_rep(payload, len, &p);
-  if (s != 0) {
-    OC_WRN("error parsing discovery response");
+static oc_discovery_flags_t
+notify_cached_resource_removed(oc_discovery_cached_resource_t *resource,
+                               oc_discovery_changes_handler_t handler,
+                               void *user_data)
+{
+  /* Present the fixed types buffer to the handler as a string array. */
+  oc_string_array_t types;
+  memset(&types, 0, sizeof(types));
+  types.ptr = resource->types;
+  types.size = resource->num_types * STRING_ARRAY_ITEM_MAX_LEN;
+  return handler(resource->anchor, resource->uri, types, resource->iface_mask,
+                 resource->eps, resource->bm, OC_DISCOVERY_RESOURCE_REMOVED,
+                 user_data);
+}
+
+static void
+free_cached_device(oc_discovery_cached_device_t *device)
+{
+  oc_discovery_cached_resource_t *resource;
+  while ((resource = oc_list_pop(device->resources)) != NULL) {
+    oc_memb_free(&discovery_cache_resources_s, resource);
+  }
+  oc_list_remove(discovery_cache, device);
+  oc_memb_free(&discovery_cache_devices_s, device);
+}
+
+void
+oc_discovery_cache_free(void)
+{
+  oc_discovery_cached_device_t *device;
+  while ((device = oc_list_head(discovery_cache)) != NULL) {
+    free_cached_device(device);
   }
-  links = rep = p;
+}
+
+void
+oc_ri_expire_discovery_cache(oc_discovery_changes_handler_t handler,
+                             void *user_data)
+{
+  if (discovery_cache_ttl == 0) {
+    return;
+  }
+  oc_clock_time_t now = oc_clock_time();
+  oc_discovery_cached_device_t *device = oc_list_head(discovery_cache), *next;
+  while (device != NULL) {
+    next = device->next;
+    if (device->expires <= now) {
+      oc_discovery_cached_resource_t *resource = oc_list_head(device->resources);
+      while (handler && resource != NULL) {
+        if (notify_cached_resource_removed(resource, handler, user_data) ==
+            OC_STOP_DISCOVERY) {
+          handler = NULL;
+        }
+        resource = resource->next;
+      }
+      free_cached_device(device);
+    }
+    device = next;
+  }
+}
+
+static oc_discovery_cached_device_t *
+get_cached_device(oc_uuid_t *di, int family)
+{
+  oc_discovery_cached_device_t *device = oc_list_head(discovery_cache);
+  while (device != NULL) {
+    if (device->family == family &&
+        memcmp(device->di.id, di->id, sizeof(di->id)) == 0) {
+      return device;
+    }
+    device = device->next;
+  }
+  device = oc_memb_alloc(&discovery_cache_devices_s);
+  if (!device) {
+    OC_WRN("discovery cache: no space for new device");
+    return NULL;
+  }
+  OC_LIST_STRUCT_INIT(device, resources);
+  memcpy(device->di.id, di->id, sizeof(di->id));
+  device->family = family;
+  device->payload_len = -1;
+  oc_list_add(discovery_cache, device);
+  return device;
+}
+
+static oc_discovery_cached_resource_t *
+get_cached_resource(oc_discovery_cached_device_t *device, const char *uri)
+{
+  oc_discovery_cached_resource_t *resource = oc_list_head(device->resources);
+  while (resource != NULL) {
+    if (strcmp(resource->uri, uri) == 0) {
+      return resource;
+    }
+    resource = resource->next;
+  }
+  return NULL;
+}
+
+static bool
+store_cached_resource(oc_discovery_cached_resource_t *resource,
+                      oc_string_t *anchor, oc_string_t *uri,
+                      oc_string_array_t *types, oc_interface_mask_t iface_mask,
+                      oc_resource_properties_t bm, oc_endpoint_t *eps,
+                      uint32_t hash)
+{
+  size_t i, num_types = oc_string_array_get_allocated_size(*types);
+  if (oc_string_len(*anchor) >= sizeof(resource->anchor) ||
+      oc_string_len(*uri) >= sizeof(resource->uri) ||
+      num_types > OC_DISCOVERY_CACHE_MAX_TYPES) {
+    return false;
+  }
+  oc_endpoint_t *ep = eps;
+  for (i = 0; ep != NULL; i++, ep = ep->next) {
+    if (i == OC_DISCOVERY_CACHE_MAX_EPS) {
+      return false;
+    }
+  }
+
+  memcpy(resource->anchor, oc_string(*anchor), oc_string_len(*anchor) + 1);
+  memcpy(resource->uri, oc_string(*uri), oc_string_len(*uri) + 1);
+  memset(resource->types, 0, sizeof(resource->types));
+  for (i = 0; i < num_types; i++) {
+    memcpy(resource->types + i * STRING_ARRAY_ITEM_MAX_LEN,
+           oc_string_array_get_item(*types, i), STRING_ARRAY_ITEM_MAX_LEN);
+  }
+  resource->num_types = num_types;
+  for (i = 0, ep = eps; ep != NULL; i++, ep = ep->next) {
+    memcpy(&resource->eps[i], ep, sizeof(oc_endpoint_t));
+    resource->eps[i].next = ep->next ? &resource->eps[i + 1] : NULL;
+  }
+  resource->iface_mask = iface_mask;
+  resource->bm = bm;
+  resource->hash = hash;
+  return true;
+}
+
+static oc_endpoint_t *
+parse_discovery_link(oc_rep_t *link, oc_endpoint_t *endpoint, oc_uuid_t *di,
+                     oc_string_t **anchor, oc_string_t **uri,
+                     oc_string_array_t **types, oc_interface_mask_t *iface_mask,
+                     oc_resource_properties_t *bm, bool *truncated)
+{
+  oc_endpoint_t *eps_list = NULL;
+
+  while (link != NULL) {
+    switch (link->type) {
+    case OC_REP_STRING: {
+      if (oc_string_len(link->name) == 6 &&
+          memcmp(oc_string(link->name), "anchor", 6) == 0) {
+        *anchor = &link->value.string;
+        oc_str_to_uuid(oc_string(**anchor) + 6, di);
+      } else if (oc_string_len(link->name) == 4 &&
+                 memcmp(oc_string(link->name), "href", 4) == 0) {
+        *uri = &link->value.string;
+      }
+    } break;
+    case OC_REP_STRING_ARRAY: {
+      size_t i;
+      if (oc_string_len(link->name) == 2 &&
+          strncmp(oc_string(link->name), "rt", 2) == 0) {
+        *types = &link->value.array;
+      } else {
+        *iface_mask = 0;
+        for (i = 0; i < oc_string_array_get_allocated_size(link->value.array);
+             i++) {
+          *iface_mask |= oc_ri_get_interface_mask(
+            oc_string_array_get_item(link->value.array, i),
+            oc_string_array_get_item_size(link->value.array, i));
+        }
+      }
+    } break;
+    case OC_REP_OBJECT_ARRAY: {
+      oc_rep_t *eps = link->value.object_array;
+      oc_endpoint_t *eps_cur = NULL;
+      oc_endpoint_t temp_ep;
+      while (eps != NULL) {
+        oc_rep_t *ep = eps->value.object;
+        while (ep != NULL) {
+          switch (ep->type) {
+          case OC_REP_STRING: {
+            if (oc_string_len(ep->name) == 2 &&
+                memcmp(oc_string(ep->name), "ep", 2) == 0) {
+              if (oc_string_to_endpoint(&ep->value.string, &temp_ep, NULL) ==
+                  0) {
+                if (!(temp_ep.flags & TCP) &&
+                    (((endpoint->flags & IPV4) && (temp_ep.flags & IPV6)) ||
+                     ((endpoint->flags & IPV6) && (temp_ep.flags & IPV4)))) {
+                  goto next_ep;
+                }
+                oc_endpoint_t *new_ep = oc_new_endpoint();
+                if (!new_ep) {
+                  OC_WRN("discovery: no space for endpoint");
+                  *truncated = true;
+                  goto next_ep;
+                }
+                if (eps_cur) {
+                  eps_cur->next = new_ep;
+                } else {
+                  eps_list = new_ep;
+                }
+                eps_cur = new_ep;
+
+                memcpy(eps_cur, &temp_ep, sizeof(oc_endpoint_t));
+                eps_cur->next = NULL;
+                eps_cur->device = endpoint->device;
+                memcpy(eps_cur->di.id, di->id, 16);
+                eps_cur->interface_index = endpoint->interface_index;
+                oc_endpoint_set_local_address(eps_cur,
+                                              endpoint->interface_index);
+                if (oc_ipv6_endpoint_is_link_local(eps_cur) == 0 &&
+                    oc_ipv6_endpoint_is_link_local(endpoint) == 0) {
+                  eps_cur->addr.ipv6.scope = endpoint->addr.ipv6.scope;
+                }
+                eps_cur->version = endpoint->version;
+              }
+            }
+          } break;
+          default:
+            break;
+          }
+          ep = ep->next;
+        }
+      next_ep:
+        eps = eps->next;
+      }
+    } break;
+    case OC_REP_OBJECT: {
+      oc_rep_t *policy = link->value.object;
+      if (policy != NULL && oc_string_len(link->name) == 1 &&
+          *(oc_string(link->name)) == 'p' && policy->type == OC_REP_INT &&
+          oc_string_len(policy->name) == 2 &&
+          memcmp(oc_string(policy->name), "bm", 2) == 0) {
+        *bm = policy->value.integer;
+      }
+    } break;
+    default:
+      break;
+    }
+    link = link->next;
+  }
+
+  return eps_list;
+}
+
+static oc_rep_t *
+get_discovery_links(oc_rep_t *rep)
+{
+  oc_rep_t *links = rep;
   /*  While the oic.wk.res schema over the baseline interface provides for an
    *  array of objects, only one object is present and used in practice.
    *
@@ -586,105 +1240,217 @@ oc_ri_process_discovery_payload(uint8_t *payload, int len,
     rep = rep->next;
   }
 
+  return links;
+}
+
+static oc_discovery_flags_t
+process_discovery_changes(oc_rep_t *links, uint8_t *payload, int len,
+                          oc_discovery_changes_handler_t handler,
+                          oc_endpoint_t *endpoint, void *user_data)
+{
+  oc_discovery_flags_t ret = OC_CONTINUE_DISCOVERY;
+  oc_string_t *uri = NULL;
+  oc_string_t *anchor = NULL;
+  oc_string_array_t *types = NULL;
+  oc_interface_mask_t iface_mask = 0;
+  oc_discovery_cached_device_t *device = NULL;
+  int family = endpoint->flags & (IPV4 | IPV6);
+
   while (links != NULL) {
-    /* Reset bm in every round as this can be omitted if 0. */
     oc_uuid_t di;
     oc_resource_properties_t bm = 0;
-    oc_endpoint_t *eps_list = NULL;
-    oc_rep_t *link = links->value.object;
-
-    while (link != NULL) {
-      switch (link->type) {
-      case OC_REP_STRING: {
-        if (oc_string_len(link->name) == 6 &&
-            memcmp(oc_string(link->name), "anchor", 6) == 0) {
-          anchor = &link->value.string;
-          oc_str_to_uuid(oc_string(*anchor) + 6, &di);
-        } else if (oc_string_len(link->name) == 4 &&
-                   memcmp(oc_string(link->name), "href", 4) == 0) {
-          uri = &link->value.string;
+    bool truncated = false;
+    oc_endpoint_t *eps_list =
+      parse_discovery_link(links->value.object, endpoint, &di, &anchor, &uri,
+                           &types, &iface_mask, &bm, &truncated);
+    links = links->next;
+    if (!eps_list) {
+      continue;
+    }
+    if (!anchor || !uri || !types) {
+      oc_free_server_endpoints(eps_list);
+      continue;
+    }
+
+    if (!device || memcmp(device->di.id, di.id, sizeof(di.id)) != 0) {
+      device = get_cached_device(&di, family);
+      if (device && !device->updating) {
+        oc_discovery_cached_resource_t *r = oc_list_head(device->resources);
+        while (r != NULL) {
+          r->seen = false;
+          r = r->next;
         }
-      } break;
-      case OC_REP_STRING_ARRAY: {
-        size_t i;
-        if (oc_string_len(link->name) == 2 &&
-            strncmp(oc_string(link->name), "rt", 2) == 0) {
-          types = &link->value.array;
-        } else {
-          iface_mask = 0;
-          for (i = 0; i < oc_string_array_get_allocated_size(link->value.array);
-               i++) {
-            iface_mask |= oc_ri_get_interface_mask(
-              oc_string_array_get_item(link->value.array, i),
-              oc_string_array_get_item_size(link->value.array, i));
-          }
+        device->updating = true;
+        device->payload_len = len;
+      }
+    }
+
+    oc_discovery_change_t change = OC_DISCOVERY_RESOURCE_ADDED;
+    oc_discovery_cached_resource_t *resource = NULL;
+    uint32_t hash =
+      hash_discovery_link(oc_string(*uri), types, iface_mask, bm, eps_list);
+    if (device) {
+      resource = get_cached_resource(device, oc_string(*uri));
+      if (resource) {
+        resource->seen = true;
+        if (resource->hash == hash && !truncated) {
+          oc_free_server_endpoints(eps_list);
+          continue;
         }
-      } break;
-      case OC_REP_OBJECT_ARRAY: {
-        oc_rep_t *eps = link->value.object_array;
-        oc_endpoint_t *eps_cur = NULL;
-        oc_endpoint_t temp_ep;
-        while (eps != NULL) {
-          oc_rep_t *ep = eps->value.object;
-          while (ep != NULL) {
-            switch (ep->type) {
-            case OC_REP_STRING: {
-              if (oc_string_len(ep->name) == 2 &&
-                  memcmp(oc_string(ep->name), "ep", 2) == 0) {
-                if (oc_string_to_endpoint(&ep->value.string, &temp_ep, NULL) ==
-                    0) {
-                  if (!(temp_ep.flags & TCP) &&
-                      (((endpoint->flags & IPV4) && (temp_ep.flags & IPV6)) ||
-                       ((endpoint->flags & IPV6) && (temp_ep.flags & IPV4)))) {
-                    goto next_ep;
-                  }
-                  if (eps_cur) {
-                    eps_cur->next = oc_new_endpoint();
-                    eps_cur = eps_cur->next;
-                  } else {
-                    eps_cur = eps_list = oc_new_endpoint();
-                  }
-
-                  if (eps_cur) {
-                    memcpy(eps_cur, &temp_ep, sizeof(oc_endpoint_t));
-                    eps_cur->next = NULL;
-                    eps_cur->device = endpoint->device;
-                    memcpy(eps_cur->di.id, di.id, 16);
-                    eps_cur->interface_index = endpoint->interface_index;
-                    oc_endpoint_set_local_address(eps_cur,
-                                                  endpoint->interface_index);
-                    if (oc_ipv6_endpoint_is_link_local(eps_cur) == 0 &&
-                        oc_ipv6_endpoint_is_link_local(endpoint) == 0) {
-                      eps_cur->addr.ipv6.scope = endpoint->addr.ipv6.scope;
-                    }
-                    eps_cur->version = endpoint->version;
-                  }
-                }
-              }
-            } break;
-            default:
-              break;
-            }
-            ep = ep->next;
-          }
-        next_ep:
-          eps = eps->next;
+        change = OC_DISCOVERY_RESOURCE_CHANGED;
+      } else {
+        resource = oc_memb_alloc(&discovery_cache_resources_s);
+        if (resource) {
+          resource->seen = true;
+          oc_list_add(device->resources, resource);
+        } else {
+          OC_WRN("discovery cache: no space for new resource");
         }
-      } break;
-      case OC_REP_OBJECT: {
-        oc_rep_t *policy = link->value.object;
-        if (policy != NULL && oc_string_len(link->name) == 1 &&
-            *(oc_string(link->name)) == 'p' && policy->type == OC_REP_INT &&
-            oc_string_len(policy->name) == 2 &&
-            memcmp(oc_string(policy->name), "bm", 2) == 0) {
-          bm = policy->value.integer;
+      }
+
+      if (resource &&
+          (truncated || !store_cached_resource(resource, anchor, uri, types,
+                                               iface_mask, bm, eps_list,
+                                               hash))) {
+        OC_WRN("discovery cache: link does not fit in the cache");
+        oc_list_remove(device->resources, resource);
+        oc_memb_free(&discovery_cache_resources_s, resource);
+        resource = NULL;
+      }
+      if (!resource) {
+        /* Never short-circuit this payload, so the resource is offered
+         * again on the next reply. */
+        device->payload_len = -1;
+      }
+    }
+
+    ret = handler(oc_string(*anchor), oc_string(*uri), *types, iface_mask,
+                  eps_list, bm, change, user_data);
+    oc_free_server_endpoints(eps_list);
+    if (ret == OC_STOP_DISCOVERY) {
+      break;
+    }
+  }
+
+  uint32_t payload_hash = discovery_hash(2166136261u, payload, (size_t)len);
+  oc_clock_time_t expires =
+    oc_clock_time() + (oc_clock_time_t)discovery_cache_ttl * OC_CLOCK_SECOND;
+  for (device = oc_list_head(discovery_cache); device != NULL;
+       device = device->next) {
+    if (!device->updating) {
+      continue;
+    }
+    device->updating = false;
+    if (ret == OC_STOP_DISCOVERY) {
+      /* The application stopped before the whole payload was processed, so
+       * leave unseen resources cached and never short-circuit this payload.
+       */
+      device->payload_len = -1;
+      continue;
+    }
+    device->payload_hash = payload_hash;
+    device->expires = expires;
+    oc_discovery_cached_resource_t *resource = oc_list_head(device->resources),
+                                   *next;
+    while (resource != NULL) {
+      next = resource->next;
+      if (!resource->seen) {
+        ret = notify_cached_resource_removed(resource, handler, user_data);
+        oc_list_remove(device->resources, resource);
+        oc_memb_free(&discovery_cache_resources_s, resource);
+        if (ret == OC_STOP_DISCOVERY) {
+          device->payload_len = -1;
+          break;
         }
-      } break;
-      default:
-        break;
       }
-      link = link->next;
+      resource = next;
     }
+  }
+
+  return ret;
+}
+
+static bool
+is_cached_discovery_payload(uint8_t *payload, int len, oc_endpoint_t *endpoint)
+{
+  int family = endpoint->flags & (IPV4 | IPV6);
+  uint32_t payload_hash = 0;
+  oc_discovery_cached_device_t *device = oc_list_head(discovery_cache);
+  while (device != NULL) {
+    if (device->family == family && device->payload_len == len) {
+      if (payload_hash == 0) {
+        payload_hash = discovery_hash(2166136261u, payload, (size_t)len);
+      }
+      if (device->payload_hash == payload_hash) {
+        device->expires = oc_clock_time() + (oc_clock_time_t)discovery_cache_ttl *
+                                              OC_CLOCK_SECOND;
+        return true;
+      }
+    }
+    device = device->next;
+  }
+  return false;
+}
+
+oc_discovery_flags_t
+oc_ri_process_discovery_payload(uint8_t *payload, int len,
+                                oc_client_handler_t client_handler,
+                                oc_endpoint_t *endpoint, void *user_data)
+{
+  oc_discovery_handler_t handler = client_handler.discovery;
+  oc_discovery_all_handler_t all_handler = client_handler.discovery_all;
+  bool all = false;
+  if (all_handler) {
+    all = true;
+  }
+
+  if (client_handler.discovery_changes &&
+      is_cached_discovery_payload(payload, len, endpoint)) {
+    OC_DBG("discovery response unchanged since last seen");
+    return OC_CONTINUE_DISCOVERY;
+  }
+
+  oc_discovery_flags_t ret = OC_CONTINUE_DISCOVERY;
+  oc_string_t *uri = NULL;
+  oc_string_t *anchor = NULL;
+  oc_string_array_t *types = NULL;
+  oc_interface_mask_t iface_mask = 0;
+
+#ifndef OC_DYNAMIC_ALLOCATION
+  char rep_objects_alloc[OC_MAX_NUM_REP_OBJECTS];
+  oc_rep_t rep_objects_pool[OC_MAX_NUM_REP_OBJECTS];
+  memset(rep_objects_alloc, 0, OC_MAX_NUM_REP_OBJECTS * sizeof(char));
+  memset(rep_objects_pool, 0, OC_MAX_NUM_REP_OBJECTS * sizeof(oc_rep_t));
+  struct oc_memb rep_objects = { sizeof(oc_rep_t), OC_MAX_NUM_REP_OBJECTS,
+                                 rep_objects_alloc, (void *)rep_objects_pool,
+                                 0 };
+#else  /* !OC_DYNAMIC_ALLOCATION */
+  struct oc_memb rep_objects = { sizeof(oc_rep_t), 0, 0, 0, 0 };
+#endif /* OC_DYNAMIC_ALLOCATION */
+  oc_rep_set_pool(&rep_objects);
+
+  oc_rep_t *links = 0, *p;
+  int s = oc_parse_rep(payload, len, &p);
+  if (s != 0) {
+    OC_WRN("error parsing discovery response");
+  }
+  links = get_discovery_links(p);
+
+  if (client_handler.discovery_changes) {
+    ret = process_discovery_changes(links, payload, len,
+                                    client_handler.discovery_changes, endpoint,
+                                    user_data);
+    goto done;
+  }
+
+  while (links != NULL) {
+    /* Reset bm in every round as this can be omitted if 0. */
+    oc_uuid_t di;
+    oc_resource_properties_t bm = 0;
+    bool truncated = false;
+    oc_endpoint_t *eps_list =
+      parse_discovery_link(links->value.object, endpoint, &di, &anchor, &uri,
+                           &types, &iface_mask, &bm, &truncated);
 
     if (eps_list &&
         (all ? all_handler(oc_string(*anchor), oc_string(*uri), *types,
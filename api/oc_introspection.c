@@ -45,15 +45,148 @@ gen_idd_tag(const char *name, size_t device_index, char *idd_tag)
   idd_tag[idd_tag_len - 1] = '\0';
 }
 
+#if defined(OC_BLOCK_WISE) && defined(OC_DYNAMIC_ALLOCATION)
+#define OC_IDD_CACHE
+#endif /* OC_BLOCK_WISE && OC_DYNAMIC_ALLOCATION */
+
+#ifdef OC_IDD_CACHE
+#include "oc_blockwise.h"
+#include "util/oc_list.h"
+#include "util/oc_memb.h"
+
+/* IDD of a device, loaded once and served in place through block-wise
+ * transfers
+ */
+typedef struct oc_idd_cache_s
+{
+  struct oc_idd_cache_s *next;
+  size_t device;
+  uint8_t *data;
+  size_t size;
+  uint8_t etag[COAP_ETAG_LEN];
+} oc_idd_cache_t;
+
+OC_LIST(idd_cache);
+OC_MEMB(idd_cache_s, oc_idd_cache_t, 1);
+
+/* 64-bit FNV-1a hash of the IDD, used as its ETag */
+static void
+gen_idd_etag(const uint8_t *data, size_t size, uint8_t *etag)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  size_t i;
+  for (i = 0; i < size; i++) {
+    hash ^= data[i];
+    hash *= 1099511628211ULL;
+  }
+  for (i = 0; i < COAP_ETAG_LEN; i++) {
+    etag[i] = (uint8_t)(hash >> (8 * i));
+  }
+}
+
+static oc_idd_cache_t *
+find_idd_cache(size_t device)
+{
+  oc_idd_cache_t *idd = (oc_idd_cache_t *)oc_list_head(idd_cache);
+  while (idd != NULL && idd->device != device) {
+    idd = idd->next;
+  }
+  return idd;
+}
+
+static void
+free_idd_cache(oc_idd_cache_t *idd)
+{
+  oc_blockwise_release_external_payload(idd->data);
+  oc_list_remove(idd_cache, idd);
+  free(idd->data);
+  oc_memb_free(&idd_cache_s, idd);
+}
+
+/* Takes ownership of data */
+static oc_idd_cache_t *
+store_idd_cache(size_t device, uint8_t *data, size_t size)
+{
+  oc_idd_cache_t *idd = find_idd_cache(device);
+  if (idd) {
+    free_idd_cache(idd);
+  }
+  idd = (oc_idd_cache_t *)oc_memb_alloc(&idd_cache_s);
+  if (!idd) {
+    OC_WRN("insufficient memory to cache introspection data");
+    free(data);
+    return NULL;
+  }
+  idd->device = device;
+  idd->data = data;
+  idd->size = size;
+  gen_idd_etag(data, size, idd->etag);
+  oc_list_add(idd_cache, idd);
+  return idd;
+}
+
+static oc_idd_cache_t *
+load_idd_cache(size_t device)
+{
+  char idd_tag[MAX_TAG_LENGTH];
+  gen_idd_tag("IDD", device, idd_tag);
+  size_t size = OC_MAX_APP_DATA_SIZE;
+  uint8_t *data = NULL;
+  long IDD_size;
+  for (;;) {
+    uint8_t *buf = (uint8_t *)realloc(data, size);
+    if (!buf) {
+      OC_ERR("insufficient memory to load introspection data");
+      free(data);
+      return NULL;
+    }
+    data = buf;
+    IDD_size = oc_storage_read(idd_tag, data, size);
+    if (IDD_size < 0) {
+      free(data);
+      return NULL;
+    }
+    if ((size_t)IDD_size < size) {
+      break;
+    }
+    size *= 2;
+  }
+  return store_idd_cache(device, data, (size_t)IDD_size);
+}
+#endif /* OC_IDD_CACHE */
+
 void
 oc_set_introspection_data(size_t device, uint8_t *IDD, size_t IDD_size)
 {
   char idd_tag[MAX_TAG_LENGTH];
   gen_idd_tag("IDD", device, idd_tag);
   oc_storage_write(idd_tag, IDD, IDD_size);
+#ifdef OC_IDD_CACHE
+  uint8_t *data = (uint8_t *)malloc(IDD_size);
+  if (data) {
+    memcpy(data, IDD, IDD_size);
+    store_idd_cache(device, data, IDD_size);
+  } else {
+    oc_idd_cache_t *idd = find_idd_cache(device);
+    if (idd) {
+      free_idd_cache(idd);
+    }
+  }
+#endif /* OC_IDD_CACHE */
 }
 #endif /*OC_IDD_API*/
 
+void
+oc_introspection_free_cache(void)
+{
+#ifdef OC_IDD_CACHE
+  oc_idd_cache_t *idd;
+  while ((idd = (oc_idd_cache_t *)oc_list_head(idd_cache)) != NULL) {
+    free_idd_cache(idd);
+  }
+#endif /* OC_IDD_CACHE */
+}
+
 static void
 oc_core_introspection_data_handler(oc_request_t *request,
                                    oc_interface_mask_t iface_mask, void *data)
@@ -72,7 +205,21 @@ oc_core_introspection_data_handler(oc_request_t *request,
   } else {
     IDD_size = -1;
   }
-#else  /* OC_IDD_API */
+#elif defined(OC_IDD_CACHE)
+  oc_idd_cache_t *idd = find_idd_cache(request->resource->device);
+  if (!idd) {
+    idd = load_idd_cache(request->resource->device);
+  }
+  if (idd) {
+    request->response->response_buffer->payload = idd->data;
+    request->response->response_buffer->payload_size = (uint32_t)idd->size;
+    request->response->response_buffer->etag = idd->etag;
+    request->response->response_buffer->response_length = 0;
+    request->response->response_buffer->code = oc_status_code(OC_STATUS_OK);
+    return;
+  }
+  IDD_size = -1;
+#else  /* OC_IDD_CACHE */
   char idd_tag[MAX_TAG_LENGTH];
   gen_idd_tag("IDD", request->resource->device, idd_tag);
   IDD_size = oc_storage_read(
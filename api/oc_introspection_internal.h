@@ -24,4 +24,9 @@
 */
 void oc_create_introspection_resource(size_t device);
 
+/**
+@brief Release the introspection data cached for all devices.
+*/
+void oc_introspection_free_cache(void);
+
 #endif /* OC_INTROSPECTION_INTERNAL_H */
@@ -22,13 +22,20 @@
 #include "port/oc_connectivity.h"
 
 #include "util/oc_etimer.h"
+#include "util/oc_mem_budget.h"
 #include "util/oc_process.h"
 
 #include "oc_api.h"
 #include "oc_core_res.h"
+#include "oc_discovery.h"
 #include "oc_introspection_internal.h"
+#include "oc_metrics.h"
 #include "oc_signal_event_loop.h"
 
+#ifdef OC_BLOCK_WISE
+#include "oc_blockwise.h"
+#endif /* OC_BLOCK_WISE */
+
 #if defined(OC_COLLECTIONS) && defined(OC_SERVER) &&                           \
   defined(OC_COLLECTIONS_IF_CREATE)
 #include "oc_collection.h"
@@ -61,6 +68,12 @@
 
 #include "oc_main.h"
 
+/* Events delivered per oc_process_run_n() call before expired timers are
+ * collected again. */
+#ifndef OC_MAIN_POLL_BATCH
+#define OC_MAIN_POLL_BATCH (16)
+#endif /* !OC_MAIN_POLL_BATCH */
+
 static bool initialized = false;
 static const oc_handler_t *app_callbacks;
 static oc_factory_presets_t factory_presets;
@@ -192,6 +205,15 @@ oc_main_init(const oc_handler_t *handler)
   oc_mem_trace_init();
 #endif /* OC_MEMORY_TRACE */
 
+#ifdef OC_MEMORY_BUDGET
+#ifdef OC_BLOCK_WISE
+  oc_mem_budget_set_evictor(OC_MEM_BLOCKWISE, oc_blockwise_evict_oldest);
+#endif /* OC_BLOCK_WISE */
+#ifdef OC_SECURITY
+  oc_mem_budget_set_evictor(OC_MEM_TLS_PEERS, oc_tls_evict_idle_peer);
+#endif /* OC_SECURITY */
+#endif /* OC_MEMORY_BUDGET */
+
   oc_ri_init();
   oc_core_init();
   oc_network_event_handler_mutex_init();
@@ -270,7 +292,13 @@ oc_clock_time_t
 oc_main_poll(void)
 {
   oc_clock_time_t ticks_until_next_event = oc_etimer_request_poll();
-  while (oc_process_run()) {
+#ifdef OC_MEMORY_BUDGET
+  oc_mem_budget_evict();
+#endif /* OC_MEMORY_BUDGET */
+  while (oc_process_run_n(OC_MAIN_POLL_BATCH)) {
+#ifdef OC_MEMORY_BUDGET
+    oc_mem_budget_evict();
+#endif /* OC_MEMORY_BUDGET */
     ticks_until_next_event = oc_etimer_request_poll();
   }
   return ticks_until_next_event;
@@ -292,8 +320,17 @@ oc_main_shutdown(void)
   oc_collections_free_rt_factories();
 #endif /* OC_COLLECTIONS && OC_SERVER && OC_COLLECTIONS_IF_CREATE */
 
+  oc_discovery_free_delayed_responses();
+#ifdef OC_CLIENT
+  oc_discovery_cache_free();
+#endif /* OC_CLIENT */
+
   oc_ri_shutdown();
 
+#ifdef OC_METRICS
+  oc_metrics_free();
+#endif /* OC_METRICS */
+
 #ifdef OC_SECURITY
   oc_sec_acl_free();
   oc_sec_cred_free();
@@ -0,0 +1,280 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#ifdef OC_METRICS
+#include "oc_metrics.h"
+#include "oc_api.h"
+#include "port/oc_log.h"
+#include "util/oc_list.h"
+#include "util/oc_memb.h"
+#include <string.h>
+
+#ifndef OC_MAX_METRICS_RESOURCES
+#ifdef OC_DYNAMIC_ALLOCATION
+#define OC_MAX_METRICS_RESOURCES (64)
+#else /* OC_DYNAMIC_ALLOCATION */
+#define OC_MAX_METRICS_RESOURCES (OC_MAX_APP_RESOURCES)
+#endif /* !OC_DYNAMIC_ALLOCATION */
+#endif /* !OC_MAX_METRICS_RESOURCES */
+
+/* Counters may be bumped from the network thread (oc_recv_message) as well
+ * as from the event loop, so updates are relaxed atomics where the compiler
+ * offers them. Readers only need each counter to be torn-free.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define METRICS_ADD(var, delta)                                                \
+  __atomic_fetch_add(&(var), (delta), __ATOMIC_RELAXED)
+#define METRICS_LOAD(var) __atomic_load_n(&(var), __ATOMIC_RELAXED)
+#define METRICS_STORE(var, val)                                                \
+  __atomic_store_n(&(var), (val), __ATOMIC_RELAXED)
+#else /* __GNUC__ || __clang__ */
+#define METRICS_ADD(var, delta) ((var) += (delta))
+#define METRICS_LOAD(var) (var)
+#define METRICS_STORE(var, val) ((var) = (val))
+#endif /* !__GNUC__ && !__clang__ */
+
+typedef struct oc_metrics_resource_s
+{
+  struct oc_metrics_resource_s *next;
+  oc_resource_t *resource;
+  oc_metrics_histogram_t latency;
+} oc_metrics_resource_t;
+
+OC_LIST(metrics_resources);
+OC_MEMB(metrics_resources_s, oc_metrics_resource_t, OC_MAX_METRICS_RESOURCES);
+
+static uint32_t counters[OC_METRICS_NUM_COUNTERS];
+static oc_metrics_histogram_t handler_latency;
+static const uint32_t latency_bounds[OC_METRICS_LATENCY_BUCKETS - 1] =
+  OC_METRICS_LATENCY_BOUNDS_US;
+
+static const char *counter_names[OC_METRICS_NUM_COUNTERS] = {
+  "rx", "tx", "rxdrop", "txdrop", "txnfull", "retx",
+  "txntimeout", "bwtimeout", "observers", "hsfail", "requests", "rejected"
+};
+
+void
+oc_metrics_add(oc_metrics_counter_t id, int32_t delta)
+{
+  if (id < OC_METRICS_NUM_COUNTERS) {
+    METRICS_ADD(counters[id], (uint32_t)delta);
+  }
+}
+
+const char *
+oc_metrics_counter_name(oc_metrics_counter_t id)
+{
+  if (id < OC_METRICS_NUM_COUNTERS) {
+    return counter_names[id];
+  }
+  return NULL;
+}
+
+static void
+histogram_add(oc_metrics_histogram_t *h, uint32_t elapsed_us)
+{
+  int i;
+  for (i = 0; i < OC_METRICS_LATENCY_BUCKETS - 1; i++) {
+    if (elapsed_us <= latency_bounds[i]) {
+      break;
+    }
+  }
+  h->buckets[i]++;
+  h->count++;
+  h->total_us += elapsed_us;
+  if (elapsed_us > h->max_us) {
+    h->max_us = elapsed_us;
+  }
+}
+
+static oc_metrics_resource_t *
+find_resource(oc_resource_t *resource)
+{
+  oc_metrics_resource_t *m =
+    (oc_metrics_resource_t *)oc_list_head(metrics_resources);
+  while (m && m->resource != resource) {
+    m = m->next;
+  }
+  return m;
+}
+
+/* Histograms are only touched from the event loop that dispatches requests,
+ * so they are plain (non-atomic) updates.
+ */
+void
+oc_metrics_record_latency(oc_resource_t *resource, uint32_t elapsed_us)
+{
+  histogram_add(&handler_latency, elapsed_us);
+  if (!resource) {
+    return;
+  }
+  oc_metrics_resource_t *m = find_resource(resource);
+  if (!m) {
+    m = (oc_metrics_resource_t *)oc_memb_alloc(&metrics_resources_s);
+    if (!m) {
+      OC_DBG("metrics: no room for a per-resource histogram");
+      return;
+    }
+    m->resource = resource;
+    oc_list_add(metrics_resources, m);
+  }
+  histogram_add(&m->latency, elapsed_us);
+}
+
+void
+oc_metrics_free_resource(oc_resource_t *resource)
+{
+  oc_metrics_resource_t *m = find_resource(resource);
+  if (m) {
+    oc_list_remove(metrics_resources, m);
+    oc_memb_free(&metrics_resources_s, m);
+  }
+}
+
+void
+oc_metrics_snapshot(oc_metrics_t *out)
+{
+  int i;
+  for (i = 0; i < OC_METRICS_NUM_COUNTERS; i++) {
+    out->counters[i] = METRICS_LOAD(counters[i]);
+  }
+  memcpy(&out->handler_latency, &handler_latency,
+         sizeof(oc_metrics_histogram_t));
+}
+
+int
+oc_metrics_resource_latency(oc_resource_t *resource,
+                            oc_metrics_histogram_t *out)
+{
+  oc_metrics_resource_t *m = find_resource(resource);
+  if (!m) {
+    return -1;
+  }
+  memcpy(out, &m->latency, sizeof(oc_metrics_histogram_t));
+  return 0;
+}
+
+void
+oc_metrics_reset(void)
+{
+  int i;
+  for (i = 0; i < OC_METRICS_NUM_COUNTERS; i++) {
+    /* The observer count is a gauge, not an event counter. */
+    if (i != OC_METRICS_OBSERVERS) {
+      METRICS_STORE(counters[i], 0);
+    }
+  }
+  memset(&handler_latency, 0, sizeof(oc_metrics_histogram_t));
+  oc_metrics_resource_t *m =
+    (oc_metrics_resource_t *)oc_list_head(metrics_resources);
+  while (m) {
+    memset(&m->latency, 0, sizeof(oc_metrics_histogram_t));
+    m = m->next;
+  }
+}
+
+void
+oc_metrics_free(void)
+{
+  oc_metrics_resource_t *m =
+    (oc_metrics_resource_t *)oc_list_pop(metrics_resources);
+  while (m) {
+    oc_memb_free(&metrics_resources_s, m);
+    m = (oc_metrics_resource_t *)oc_list_pop(metrics_resources);
+  }
+}
+
+#ifdef OC_SERVER
+static void
+encode_histogram(CborEncoder *parent, const char *key,
+                 oc_metrics_histogram_t *h)
+{
+  CborEncoder map, buckets;
+  int i;
+  g_err |= cbor_encode_text_string(parent, key, strlen(key));
+  g_err |= cbor_encoder_create_map(parent, &map, CborIndefiniteLength);
+  g_err |= cbor_encode_text_string(&map, "count", 5);
+  g_err |= cbor_encode_uint(&map, h->count);
+  g_err |= cbor_encode_text_string(&map, "totalus", 7);
+  g_err |= cbor_encode_uint(&map, h->total_us);
+  g_err |= cbor_encode_text_string(&map, "maxus", 5);
+  g_err |= cbor_encode_uint(&map, h->max_us);
+  g_err |= cbor_encode_text_string(&map, "buckets", 7);
+  g_err |=
+    cbor_encoder_create_array(&map, &buckets, OC_METRICS_LATENCY_BUCKETS);
+  for (i = 0; i < OC_METRICS_LATENCY_BUCKETS; i++) {
+    g_err |= cbor_encode_uint(&buckets, h->buckets[i]);
+  }
+  g_err |= cbor_encoder_close_container(&map, &buckets);
+  g_err |= cbor_encoder_close_container(parent, &map);
+}
+
+static void
+get_metrics(oc_request_t *request, oc_interface_mask_t iface_mask,
+            void *user_data)
+{
+  (void)user_data;
+  oc_metrics_t m;
+  int i;
+  oc_metrics_snapshot(&m);
+
+  oc_rep_start_root_object();
+  if (iface_mask == OC_IF_BASELINE) {
+    oc_process_baseline_interface(request->resource);
+  }
+  for (i = 0; i < OC_METRICS_NUM_COUNTERS; i++) {
+    g_err |= cbor_encode_text_string(&root_map, counter_names[i],
+                                     strlen(counter_names[i]));
+    g_err |= cbor_encode_uint(&root_map, m.counters[i]);
+  }
+  encode_histogram(&root_map, "latency", &m.handler_latency);
+  oc_rep_end_root_object();
+  oc_send_response(request, OC_STATUS_OK);
+}
+
+static void
+post_metrics(oc_request_t *request, oc_interface_mask_t iface_mask,
+             void *user_data)
+{
+  (void)iface_mask;
+  (void)user_data;
+  oc_metrics_reset();
+  oc_send_response(request, OC_STATUS_CHANGED);
+}
+
+oc_resource_t *
+oc_metrics_add_diagnostics_resource(size_t device)
+{
+  oc_resource_t *res = oc_new_resource("metrics", "/oc/metrics", 1, device);
+  if (!res) {
+    return NULL;
+  }
+  oc_resource_bind_resource_type(res, "x.org.iotivity.metrics");
+  oc_resource_bind_resource_interface(res, OC_IF_R | OC_IF_RW);
+  oc_resource_set_default_interface(res, OC_IF_R);
+  oc_resource_set_discoverable(res, true);
+  oc_resource_set_request_handler(res, OC_GET, get_metrics, NULL);
+  oc_resource_set_request_handler(res, OC_POST, post_metrics, NULL);
+  if (!oc_add_resource(res)) {
+    oc_delete_resource(res);
+    return NULL;
+  }
+  return res;
+}
+#endif /* OC_SERVER */
+#else  /* OC_METRICS */
+typedef int dummy_declaration;
+#endif /* !OC_METRICS */
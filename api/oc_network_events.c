@@ -18,6 +18,7 @@
 #include "oc_buffer.h"
 #include "oc_events.h"
 #include "oc_signal_event_loop.h"
+#include "oc_trace.h"
 #include "port/oc_connectivity.h"
 #include "util/oc_list.h"
 
@@ -37,11 +38,13 @@ oc_process_network_event(void)
   }
 #ifdef OC_NETWORK_MONITOR
   if (interface_up) {
-    oc_process_post(&oc_network_events, oc_events[INTERFACE_UP], NULL);
+    oc_process_post_prio(&oc_network_events, oc_events[INTERFACE_UP], NULL,
+                         OC_PROCESS_PRIO_LOW);
     interface_up = false;
   }
   if (interface_down) {
-    oc_process_post(&oc_network_events, oc_events[INTERFACE_DOWN], NULL);
+    oc_process_post_prio(&oc_network_events, oc_events[INTERFACE_DOWN], NULL,
+                         OC_PROCESS_PRIO_LOW);
     interface_down = false;
   }
 #endif /* OC_NETWORK_MONITOR */
@@ -70,6 +73,7 @@ OC_PROCESS_THREAD(oc_network_events, ev, data)
 void
 oc_network_event(oc_message_t *message)
 {
+  OC_TRACE_MESSAGE(OC_TRACE_NETWORK_EVENT, message);
   if (!oc_process_is_running(&(oc_network_events))) {
     oc_message_unref(message);
     return;
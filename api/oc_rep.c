@@ -19,6 +19,7 @@
 #include "oc_config.h"
 #include "port/oc_assert.h"
 #include "port/oc_log.h"
+#include "util/oc_mem_budget.h"
 #include "util/oc_memb.h"
 
 #include <inttypes.h>
@@ -54,6 +55,29 @@ oc_rep_get_encoder_buf(void)
   return g_buf;
 }
 
+const uint8_t *
+oc_rep_get_encoder_pos(const CborEncoder *encoder)
+{
+  if (g_err != CborNoError || !encoder->end) {
+    return NULL;
+  }
+  return encoder->data.ptr;
+}
+
+void
+oc_rep_encode_raw(CborEncoder *encoder, const uint8_t *data, size_t len)
+{
+  if (g_err != CborNoError) {
+    return;
+  }
+  if (!encoder->end || (size_t)(encoder->end - encoder->data.ptr) < len) {
+    g_err = CborErrorOutOfMemory;
+    return;
+  }
+  memcpy(encoder->data.ptr, data, len);
+  encoder->data.ptr += len;
+}
+
 int
 oc_rep_get_encoded_payload_size(void)
 {
@@ -70,9 +94,14 @@ oc_rep_get_encoded_payload_size(void)
 static oc_rep_t *
 _alloc_rep(void)
 {
+  if (!OC_MEM_CHARGE(OC_MEM_REP, sizeof(oc_rep_t))) {
+    return NULL;
+  }
   oc_rep_t *rep = oc_memb_alloc(rep_objects);
   if (rep != NULL) {
     rep->name.size = 0;
+  } else {
+    OC_MEM_RELEASE(OC_MEM_REP, sizeof(oc_rep_t));
   }
 #ifdef OC_DEBUG
   oc_assert(rep != NULL);
@@ -84,6 +113,7 @@ static void
 _free_rep(oc_rep_t *rep_value)
 {
   oc_memb_free(rep_objects, rep_value);
+  OC_MEM_RELEASE(OC_MEM_REP, sizeof(oc_rep_t));
 }
 
 void
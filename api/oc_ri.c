@@ -36,14 +36,23 @@
 #include "oc_core_res.h"
 #include "oc_discovery.h"
 #include "oc_events.h"
+#include "oc_metrics.h"
+#include "oc_trace.h"
 #include "oc_network_events.h"
 #ifdef OC_TCP
 #include "oc_session_events.h"
 #endif /* OC_TCP */
+#ifdef OC_SERVER
+#include "api/oc_deferred_response_internal.h"
+#endif /* OC_SERVER */
 #include "oc_api.h"
 #include "oc_ri.h"
 #include "oc_uuid.h"
 
+#ifdef OC_DYNAMIC_ALLOCATION
+#include <stdlib.h>
+#endif /* OC_DYNAMIC_ALLOCATION */
+
 #ifdef OC_BLOCK_WISE
 #include "oc_blockwise.h"
 #endif /* OC_BLOCK_WISE */
@@ -61,6 +70,81 @@
 OC_LIST(app_resources);
 OC_LIST(observe_callbacks);
 OC_MEMB(app_resources_s, oc_resource_t, OC_MAX_APP_RESOURCES);
+
+/* GETs still waiting on a separate response from a resource with request
+ * coalescing enabled; later identical GETs join the same handle. */
+#ifndef OC_MAX_COALESCED_GETS
+#define OC_MAX_COALESCED_GETS (OC_MAX_NUM_CONCURRENT_REQUESTS)
+#endif /* !OC_MAX_COALESCED_GETS */
+
+/* GETs with a longer query string are not coalesced. */
+#ifndef OC_MAX_COALESCED_QUERY_LEN
+#define OC_MAX_COALESCED_QUERY_LEN (64)
+#endif /* !OC_MAX_COALESCED_QUERY_LEN */
+
+typedef struct oc_coalesced_get_s
+{
+  struct oc_coalesced_get_s *next;
+  oc_resource_t *resource;
+  oc_interface_mask_t iface_mask;
+  uint16_t query_len;
+  char query[OC_MAX_COALESCED_QUERY_LEN];
+  oc_separate_response_t *handle;
+} oc_coalesced_get_t;
+
+OC_LIST(coalesced_gets);
+OC_MEMB(coalesced_gets_s, oc_coalesced_get_t, OC_MAX_COALESCED_GETS);
+
+/* Encoded GET responses kept for resources with a response cache TTL. When
+ * full, the entry closest to expiry makes room for a new one. Responses
+ * whose query and payload together exceed OC_MAX_CACHED_RESPONSE_SIZE are
+ * not cached. */
+#ifndef OC_MAX_CACHED_RESPONSES
+#ifdef OC_DYNAMIC_ALLOCATION
+#define OC_MAX_CACHED_RESPONSES (4)
+#else /* OC_DYNAMIC_ALLOCATION */
+#define OC_MAX_CACHED_RESPONSES (2)
+#endif /* !OC_DYNAMIC_ALLOCATION */
+#endif /* !OC_MAX_CACHED_RESPONSES */
+
+#ifndef OC_MAX_CACHED_RESPONSE_SIZE
+#ifdef OC_DYNAMIC_ALLOCATION
+#define OC_MAX_CACHED_RESPONSE_SIZE (1024)
+#else /* OC_DYNAMIC_ALLOCATION */
+#define OC_MAX_CACHED_RESPONSE_SIZE (256)
+#endif /* !OC_DYNAMIC_ALLOCATION */
+#endif /* !OC_MAX_CACHED_RESPONSE_SIZE */
+
+typedef struct oc_cached_response_s
+{
+  struct oc_cached_response_s *next;
+  oc_resource_t *resource;
+  oc_interface_mask_t iface_mask;
+  ocf_version_t version;
+  int code;
+  oc_clock_time_t expiry;
+  uint16_t query_len;
+  uint16_t payload_len;
+  /* The query followed by the payload. */
+#ifdef OC_DYNAMIC_ALLOCATION
+  uint8_t *data;
+#else  /* OC_DYNAMIC_ALLOCATION */
+  uint8_t data[OC_MAX_CACHED_RESPONSE_SIZE];
+#endif /* !OC_DYNAMIC_ALLOCATION */
+} oc_cached_response_t;
+
+OC_LIST(cached_responses);
+OC_MEMB(cached_responses_s, oc_cached_response_t, OC_MAX_CACHED_RESPONSES);
+
+/* Resources added between oc_ri_begin_resource_batch() and
+ * oc_ri_commit_resource_batch(), in the order they were added. The tail is
+ * kept so that adding to the batch does not walk it. */
+OC_LIST(resource_batch);
+static oc_resource_t *resource_batch_tail;
+static bool resource_batch_open;
+#ifndef OC_DYNAMIC_ALLOCATION
+static oc_resource_t *resource_batch_set[2 * OC_MAX_APP_RESOURCES];
+#endif /* !OC_DYNAMIC_ALLOCATION */
 #endif /* OC_SERVER */
 
 #ifdef OC_CLIENT
@@ -235,11 +319,17 @@ start_processes(void)
 #ifdef OC_TCP
   oc_process_start(&oc_session_events, NULL);
 #endif /* OC_TCP */
+#ifdef OC_SERVER
+  oc_process_start(&oc_deferred_responses, NULL);
+#endif /* OC_SERVER */
 }
 
 static void
 stop_processes(void)
 {
+#ifdef OC_SERVER
+  oc_process_exit(&oc_deferred_responses);
+#endif /* OC_SERVER */
 #ifdef OC_TCP
   oc_process_exit(&oc_session_events);
 #endif /* OC_TCP */
@@ -301,6 +391,8 @@ oc_ri_init(void)
 #ifdef OC_SERVER
   oc_list_init(app_resources);
   oc_list_init(observe_callbacks);
+  oc_list_init(coalesced_gets);
+  oc_list_init(cached_responses);
 #endif
 
 #ifdef OC_CLIENT
@@ -314,6 +406,218 @@ oc_ri_init(void)
 }
 
 #ifdef OC_SERVER
+static void
+free_coalesced_get(oc_coalesced_get_t *entry)
+{
+  oc_list_remove(coalesced_gets, entry);
+  oc_memb_free(&coalesced_gets_s, entry);
+}
+
+static oc_coalesced_get_t *
+find_coalesced_get(oc_resource_t *resource, oc_interface_mask_t iface_mask,
+                   const char *query, size_t query_len)
+{
+  oc_coalesced_get_t *entry = oc_list_head(coalesced_gets), *next;
+  while (entry != NULL) {
+    next = entry->next;
+    if (!entry->handle->active) {
+      free_coalesced_get(entry);
+    } else if (entry->resource == resource && entry->iface_mask == iface_mask &&
+               entry->query_len == query_len &&
+               (query_len == 0 || memcmp(entry->query, query, query_len) == 0)) {
+      return entry;
+    }
+    entry = next;
+  }
+  return NULL;
+}
+
+static void
+add_coalesced_get(oc_resource_t *resource, oc_interface_mask_t iface_mask,
+                  const char *query, size_t query_len,
+                  oc_separate_response_t *handle)
+{
+  if (query_len > OC_MAX_COALESCED_QUERY_LEN) {
+    return;
+  }
+  oc_coalesced_get_t *entry =
+    find_coalesced_get(resource, iface_mask, query, query_len);
+  if (entry) {
+    return;
+  }
+  entry = (oc_coalesced_get_t *)oc_memb_alloc(&coalesced_gets_s);
+  if (!entry) {
+    OC_WRN("insufficient memory to coalesce GET requests");
+    return;
+  }
+  entry->resource = resource;
+  entry->iface_mask = iface_mask;
+  if (query_len > 0) {
+    memcpy(entry->query, query, query_len);
+  }
+  entry->query_len = (uint16_t)query_len;
+  entry->handle = handle;
+  oc_list_add(coalesced_gets, entry);
+}
+
+static void
+remove_coalesced_gets_by_resource(oc_resource_t *resource)
+{
+  oc_coalesced_get_t *entry = oc_list_head(coalesced_gets), *next;
+  while (entry != NULL) {
+    next = entry->next;
+    if (entry->resource == resource) {
+      free_coalesced_get(entry);
+    }
+    entry = next;
+  }
+}
+
+static void
+free_all_coalesced_gets(void)
+{
+  oc_coalesced_get_t *entry = oc_list_head(coalesced_gets);
+  while (entry != NULL) {
+    free_coalesced_get(entry);
+    entry = oc_list_head(coalesced_gets);
+  }
+}
+
+void
+oc_ri_release_coalesced_gets(oc_separate_response_t *handle)
+{
+  oc_coalesced_get_t *entry = oc_list_head(coalesced_gets), *next;
+  while (entry != NULL) {
+    next = entry->next;
+    if (entry->handle == handle) {
+      free_coalesced_get(entry);
+    }
+    entry = next;
+  }
+}
+
+static void
+free_cached_response(oc_cached_response_t *entry)
+{
+  oc_list_remove(cached_responses, entry);
+#ifdef OC_DYNAMIC_ALLOCATION
+  free(entry->data);
+#endif /* OC_DYNAMIC_ALLOCATION */
+  oc_memb_free(&cached_responses_s, entry);
+}
+
+static oc_cached_response_t *
+find_cached_response(oc_resource_t *resource, oc_interface_mask_t iface_mask,
+                     ocf_version_t version, const char *query,
+                     size_t query_len)
+{
+  oc_clock_time_t now = oc_clock_time();
+  oc_cached_response_t *entry = oc_list_head(cached_responses), *next;
+  while (entry != NULL) {
+    next = entry->next;
+    if (entry->expiry <= now) {
+      free_cached_response(entry);
+    } else if (entry->resource == resource &&
+               entry->iface_mask == iface_mask && entry->version == version &&
+               entry->query_len == query_len &&
+               (query_len == 0 || memcmp(entry->data, query, query_len) == 0)) {
+      return entry;
+    }
+    entry = next;
+  }
+  return NULL;
+}
+
+static void
+store_cached_response(oc_resource_t *resource, oc_interface_mask_t iface_mask,
+                      ocf_version_t version, const char *query,
+                      size_t query_len, oc_response_buffer_t *response_buffer)
+{
+  size_t size = query_len + response_buffer->response_length;
+  if (size > OC_MAX_CACHED_RESPONSE_SIZE) {
+    return;
+  }
+  oc_cached_response_t *entry = (oc_cached_response_t *)oc_memb_alloc(
+    &cached_responses_s);
+  if (!entry) {
+    oc_cached_response_t *oldest = oc_list_head(cached_responses), *cur;
+    for (cur = oldest; cur != NULL; cur = cur->next) {
+      if (cur->expiry < oldest->expiry) {
+        oldest = cur;
+      }
+    }
+    if (!oldest) {
+      return;
+    }
+    free_cached_response(oldest);
+    entry = (oc_cached_response_t *)oc_memb_alloc(&cached_responses_s);
+    if (!entry) {
+      return;
+    }
+  }
+#ifdef OC_DYNAMIC_ALLOCATION
+  entry->data = (uint8_t *)malloc(size);
+  if (!entry->data) {
+    OC_WRN("insufficient memory to cache response");
+    oc_memb_free(&cached_responses_s, entry);
+    return;
+  }
+#endif /* OC_DYNAMIC_ALLOCATION */
+  if (query_len > 0) {
+    memcpy(entry->data, query, query_len);
+  }
+  memcpy(entry->data + query_len, response_buffer->buffer,
+         response_buffer->response_length);
+  entry->query_len = (uint16_t)query_len;
+  entry->payload_len = response_buffer->response_length;
+  entry->resource = resource;
+  entry->iface_mask = iface_mask;
+  entry->version = version;
+  entry->code = response_buffer->code;
+  entry->expiry =
+    oc_clock_time() + (oc_clock_time_t)resource->response_cache_ttl *
+                        OC_CLOCK_SECOND;
+  oc_list_add(cached_responses, entry);
+}
+
+static bool
+serve_cached_response(oc_cached_response_t *entry,
+                      oc_response_buffer_t *response_buffer)
+{
+  if (entry->payload_len > response_buffer->buffer_size) {
+    free_cached_response(entry);
+    return false;
+  }
+  memcpy(response_buffer->buffer, entry->data + entry->query_len,
+         entry->payload_len);
+  response_buffer->response_length = entry->payload_len;
+  response_buffer->code = entry->code;
+  return true;
+}
+
+static void
+free_all_cached_responses(void)
+{
+  oc_cached_response_t *entry = oc_list_head(cached_responses);
+  while (entry != NULL) {
+    free_cached_response(entry);
+    entry = oc_list_head(cached_responses);
+  }
+}
+
+void
+oc_ri_invalidate_cached_responses(oc_resource_t *resource)
+{
+  oc_cached_response_t *entry = oc_list_head(cached_responses), *next;
+  while (entry != NULL) {
+    next = entry->next;
+    if (entry->resource == resource) {
+      free_cached_response(entry);
+    }
+    entry = next;
+  }
+}
+
 oc_resource_t *
 oc_ri_alloc_resource(void)
 {
@@ -329,7 +633,16 @@ oc_ri_delete_resource(oc_resource_t *resource)
   if (resource->num_observers > 0) {
     coap_remove_observer_by_resource(resource);
   }
+  remove_coalesced_gets_by_resource(resource);
+  oc_ri_invalidate_cached_responses(resource);
+  oc_list_remove(resource_batch, resource);
+  if (resource == resource_batch_tail) {
+    resource_batch_tail = oc_list_tail(resource_batch);
+  }
   oc_list_remove(app_resources, resource);
+#ifdef OC_METRICS
+  oc_metrics_free_resource(resource);
+#endif /* OC_METRICS */
   oc_ri_free_resource_properties(resource);
   oc_memb_free(&app_resources_s, resource);
   return true;
@@ -352,11 +665,136 @@ oc_ri_add_resource(oc_resource_t *resource)
     valid = false;
 
   if (valid) {
-    oc_list_add(app_resources, resource);
+    if (resource_batch_open) {
+      oc_list_insert(resource_batch, resource_batch_tail, resource);
+      resource_batch_tail = resource;
+    } else {
+      oc_list_add(app_resources, resource);
+    }
   }
 
   return valid;
 }
+
+void
+oc_ri_begin_resource_batch(void)
+{
+  if (resource_batch_open) {
+    OC_WRN("resource batch already open");
+    return;
+  }
+  oc_list_init(resource_batch);
+  resource_batch_tail = NULL;
+  resource_batch_open = true;
+}
+
+static size_t
+resource_batch_hash(const oc_resource_t *resource)
+{
+  uint32_t hash = 5381;
+  size_t i, len = oc_string_len(resource->uri);
+  const char *uri = oc_string(resource->uri);
+  for (i = 0; i < len; i++) {
+    hash = ((hash << 5) + hash) + (uint8_t)uri[i];
+  }
+  hash ^= (uint32_t)resource->device;
+  return (size_t)hash;
+}
+
+/* Insert the resource into an open addressing set keyed by device and URI,
+ * or report that an equal one is already there.
+ */
+static bool
+resource_batch_set_insert(oc_resource_t **set, size_t slots,
+                          oc_resource_t *resource)
+{
+  size_t i = resource_batch_hash(resource) % slots;
+  while (set[i]) {
+    if (set[i]->device == resource->device &&
+        oc_string_len(set[i]->uri) == oc_string_len(resource->uri) &&
+        memcmp(oc_string(set[i]->uri), oc_string(resource->uri),
+               oc_string_len(resource->uri)) == 0) {
+      return false;
+    }
+    i = (i + 1) % slots;
+  }
+  set[i] = resource;
+  return true;
+}
+
+bool
+oc_ri_commit_resource_batch(void)
+{
+  if (!resource_batch_open) {
+    return true;
+  }
+  resource_batch_open = false;
+  resource_batch_tail = NULL;
+
+  oc_resource_t *batch = oc_list_head(resource_batch), *res;
+  if (!batch) {
+    return true;
+  }
+  size_t count = 0;
+  for (res = batch; res != NULL; res = res->next) {
+    count++;
+  }
+
+  oc_resource_t *tail = NULL;
+  for (res = oc_ri_get_app_resources(); res != NULL; res = res->next) {
+    tail = res;
+    count++;
+  }
+
+#ifdef OC_DYNAMIC_ALLOCATION
+  size_t slots = 16;
+  while (slots < 2 * count) {
+    slots <<= 1;
+  }
+  oc_resource_t **set = (oc_resource_t **)calloc(slots, sizeof(oc_resource_t *));
+  if (!set) {
+    OC_ERR("insufficient memory to commit resource batch");
+    goto unlink_batch;
+  }
+#else  /* OC_DYNAMIC_ALLOCATION */
+  size_t slots = 2 * OC_MAX_APP_RESOURCES;
+  oc_resource_t **set = resource_batch_set;
+  memset(set, 0, sizeof(resource_batch_set));
+#endif /* !OC_DYNAMIC_ALLOCATION */
+
+  bool unique = true;
+  for (res = oc_ri_get_app_resources(); res != NULL; res = res->next) {
+    resource_batch_set_insert(set, slots, res);
+  }
+  for (res = batch; res != NULL && unique; res = res->next) {
+    if (!resource_batch_set_insert(set, slots, res)) {
+      OC_ERR("resource batch has duplicate URI %s", oc_string(res->uri));
+      unique = false;
+    }
+  }
+#ifdef OC_DYNAMIC_ALLOCATION
+  free(set);
+#endif /* OC_DYNAMIC_ALLOCATION */
+
+  if (unique) {
+    /* Append the batch behind the tail found above, in order. */
+    while ((res = oc_list_pop(resource_batch)) != NULL) {
+      oc_list_insert(app_resources, tail, res);
+      tail = res;
+    }
+    return true;
+  }
+
+#ifdef OC_DYNAMIC_ALLOCATION
+unlink_batch:
+#endif /* OC_DYNAMIC_ALLOCATION */
+  /* Leave every resource of the batch unlinked, as a failed
+   * oc_ri_add_resource() would. */
+  while ((res = oc_list_pop(resource_batch)) != NULL) {
+    res->next = NULL;
+  }
+  return false;
+}
 #endif /* OC_SERVER */
 
 void
@@ -653,6 +1091,16 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
    */
   oc_method_t method = packet->code;
 
+#ifdef OC_SERVER
+  /* Only GETs without an observe option are coalesced or cached. */
+  uint32_t get_observe = 0;
+  bool plain_get =
+    (method == OC_GET && !coap_get_header_observe(request, &get_observe));
+  oc_coalesced_get_t *coalesced_get = NULL;
+  oc_cached_response_t *cached_response = NULL;
+  bool served_from_cache = false;
+#endif /* OC_SERVER */
+
   /* Initialize request/response objects to be sent up to the app layer. */
   oc_request_t request_obj;
   oc_response_buffer_t response_buffer;
@@ -670,6 +1118,11 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
    */
   response_buffer.code = 0;
   response_buffer.response_length = 0;
+#if defined(OC_BLOCK_WISE) && defined(OC_DYNAMIC_ALLOCATION)
+  response_buffer.payload = NULL;
+  response_buffer.payload_size = 0;
+  response_buffer.etag = NULL;
+#endif /* OC_BLOCK_WISE && OC_DYNAMIC_ALLOCATION */
 
   response_obj.separate_response = NULL;
   response_obj.response_buffer = &response_buffer;
@@ -856,6 +1309,12 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
     } else
 #endif /* OC_SECURITY */
     {
+#ifdef OC_METRICS
+      oc_clock_time_t handler_start = oc_clock_time();
+      OC_METRICS_INC(OC_METRICS_REQUESTS);
+#endif /* OC_METRICS */
+      OC_TRACE_EVENT(OC_TRACE_HANDLER_BEGIN, packet->mid, packet->token,
+                     packet->token_len);
 /* If cur_resource is a collection resource, invoke the framework's
  * internal handler for collections.
  */
@@ -864,6 +1323,28 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
         oc_handle_collection_request(method, &request_obj, iface_mask, NULL);
       } else
 #endif /* OC_COLLECTIONS && OC_SERVER */
+#ifdef OC_SERVER
+        /* A plain GET on a resource with a response cache is answered
+         * with the stored payload while it is fresh, without invoking the
+         * handler or the encoder.
+         */
+        if (plain_get && cur_resource->response_cache_ttl > 0 &&
+            (cached_response = find_cached_response(
+               cur_resource, iface_mask, endpoint->version, uri_query,
+               uri_query_len)) &&
+            serve_cached_response(cached_response, &response_buffer)) {
+        served_from_cache = true;
+      } else
+        /* A plain GET on a resource with request coalescing enabled joins
+         * an identical GET that is still awaiting its separate response,
+         * instead of invoking the handler again.
+         */
+        if (plain_get && cur_resource->coalesce_requests &&
+            (coalesced_get = find_coalesced_get(cur_resource, iface_mask,
+                                                uri_query, uri_query_len))) {
+        oc_indicate_separate_response(&request_obj, coalesced_get->handle);
+      } else
+#endif /* OC_SERVER */
         /* If cur_resource is a non-collection resource, invoke
          * its handler for the requested method. If it has not
          * implemented that method, then return a 4.05 response.
@@ -883,6 +1364,15 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
       } else {
         method_impl = false;
       }
+      OC_TRACE_EVENT(OC_TRACE_HANDLER_END, packet->mid, packet->token,
+                     packet->token_len);
+#ifdef OC_METRICS
+      if (method_impl) {
+        oc_clock_time_t elapsed = oc_clock_time() - handler_start;
+        oc_metrics_record_latency(
+          cur_resource, (uint32_t)(elapsed * 1000000 / OC_CLOCK_SECOND));
+      }
+#endif /* OC_METRICS */
     }
   }
 
@@ -935,6 +1425,16 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
   }
 
 #ifdef OC_SERVER
+  /* A successful update drops the responses cached for the resource. An
+   * update answered with a separate response has not happened yet; its
+   * cache is dropped when oc_send_separate_response() reports success.
+   */
+  if (success && cur_resource && method != OC_GET &&
+      !response_obj.separate_response &&
+      response_buffer.code < oc_status_code(OC_STATUS_BAD_REQUEST)) {
+    oc_ri_invalidate_cached_responses(cur_resource);
+  }
+
   /* If a GET request was successfully processed, then check its
    *  observe option.
    */
@@ -1066,7 +1566,13 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
     if (coap_separate_accept(request, response_obj.separate_response, endpoint,
                              observe) == 1)
 #endif /* !OC_BLOCK_WISE */
+    {
       response_obj.separate_response->active = 1;
+      if (plain_get && cur_resource && cur_resource->coalesce_requests) {
+        add_coalesced_get(cur_resource, iface_mask, uri_query, uri_query_len,
+                          response_obj.separate_response);
+      }
+    }
   } else
 #endif /* OC_SERVER */
     if (response_buffer.code == OC_IGNORE) {
@@ -1090,7 +1596,56 @@ oc_ri_invoke_coap_entity_handler(void *request, void *response, uint8_t *buffer,
       oc_ri_add_timed_event_callback_ticks(cur_resource,
                                            &oc_observe_notification_delayed, 0);
 
+    /* Keep the encoded response of a plain GET on a resource with a
+     * response cache.
+     */
+    if (
+#ifdef OC_COLLECTIONS
+      !resource_is_collection &&
+#endif /* OC_COLLECTIONS */
+#if defined(OC_BLOCK_WISE) && defined(OC_DYNAMIC_ALLOCATION)
+      !response_buffer.payload &&
+#endif /* OC_BLOCK_WISE && OC_DYNAMIC_ALLOCATION */
+      success && plain_get && !served_from_cache && cur_resource &&
+      cur_resource->response_cache_ttl > 0 &&
+      response_buffer.code == oc_status_code(OC_STATUS_OK) &&
+      response_buffer.response_length > 0) {
+      store_cached_response(cur_resource, iface_mask, endpoint->version,
+                            uri_query, uri_query_len, &response_buffer);
+    }
 #endif /* OC_SERVER */
+#if defined(OC_BLOCK_WISE) && defined(OC_DYNAMIC_ALLOCATION)
+    if (response_buffer.payload) {
+      const uint8_t *etag = NULL;
+      if (response_buffer.etag &&
+          coap_get_header_etag(request, &etag) == COAP_ETAG_LEN &&
+          memcmp(etag, response_buffer.etag, COAP_ETAG_LEN) == 0) {
+        response_buffer.code = VALID_2_03;
+        memcpy(((oc_blockwise_response_state_t *)*response_state)->etag,
+               response_buffer.etag, COAP_ETAG_LEN);
+        coap_set_header_etag(response, response_buffer.etag, COAP_ETAG_LEN);
+      }
+#ifdef OC_TCP
+      else if ((endpoint->flags & TCP) &&
+               response_buffer.payload_size > OC_MAX_APP_DATA_SIZE) {
+        OC_ERR("payload of %u bytes is too large for a TCP response",
+               (unsigned int)response_buffer.payload_size);
+        response_buffer.code =
+          oc_status_code(OC_STATUS_INTERNAL_SERVER_ERROR);
+      }
+#endif /* OC_TCP */
+      else {
+        oc_blockwise_set_external_payload(
+          *response_state, response_buffer.payload, response_buffer.payload_size);
+        if (response_buffer.etag) {
+          memcpy(((oc_blockwise_response_state_t *)*response_state)->etag,
+                 response_buffer.etag, COAP_ETAG_LEN);
+          coap_set_header_etag(response, response_buffer.etag, COAP_ETAG_LEN);
+        }
+        coap_set_header_content_format(response, APPLICATION_VND_OCF_CBOR);
+      }
+    } else
+#endif /* OC_BLOCK_WISE && OC_DYNAMIC_ALLOCATION */
     if (response_buffer.response_length > 0) {
 #ifdef OC_BLOCK_WISE
       (*response_state)->payload_size = response_buffer.response_length;
@@ -1477,6 +2032,8 @@ oc_ri_shutdown(void)
 {
 #ifdef OC_SERVER
   coap_free_all_observers();
+  free_all_coalesced_gets();
+  free_all_cached_responses();
 #endif /* OC_SERVER */
   coap_free_all_transactions();
   free_all_event_timers();
@@ -1496,6 +2053,7 @@ oc_ri_shutdown(void)
 
 #ifdef OC_SERVER
 #ifdef OC_COLLECTIONS
+  oc_collection_free_batch_responses();
   oc_collection_t *collection = oc_collection_get_all(), *next;
   while (collection != NULL) {
     next = collection->next;
@@ -1505,6 +2063,12 @@ oc_ri_shutdown(void)
 #endif /* OC_COLLECTIONS */
 
   oc_ri_delete_all_app_resources();
+  oc_resource_t *res = oc_list_head(resource_batch);
+  while (res != NULL) {
+    oc_ri_delete_resource(res);
+    res = oc_list_head(resource_batch);
+  }
+  resource_batch_open = false;
 #endif /* OC_SERVER */
 
   oc_random_destroy();
@@ -33,7 +33,7 @@
 
 #include "oc_core_res.h"
 
-static size_t query_iterator;
+static oc_query_iterator_t query_iterator;
 
 int
 oc_add_device(const char *uri, const char *rt, const char *name,
@@ -94,6 +94,7 @@ oc_set_immutable_device_identifier(size_t device, oc_uuid_t *piid)
       oc_sec_load_unique_ids(device);
 #endif /* OC_SECURITY */
       memcpy(info->piid.id, piid->id, sizeof(oc_uuid_t));
+      oc_core_invalidate_device_reps(device);
 #ifdef OC_SECURITY
       oc_sec_dump_unique_ids(device);
 #endif /* OC_SECURITY */
@@ -124,34 +125,50 @@ oc_process_baseline_interface(oc_resource_t *resource)
 }
 
 void
-oc_init_query_iterator(void)
+oc_query_iterator_init(oc_query_iterator_t *iterator,
+                       const oc_request_t *request)
 {
-  query_iterator = 0;
+  iterator->query = request->query;
+  iterator->query_len = request->query ? request->query_len : 0;
+  iterator->pos = 0;
 }
 
 int
-oc_iterate_query(oc_request_t *request, char **key, size_t *key_len,
-                 char **value, size_t *value_len)
-{
-  query_iterator++;
-  return oc_ri_get_query_nth_key_value(request->query, request->query_len, key,
-                                       key_len, value, value_len,
-                                       query_iterator);
+oc_query_iterator_next(oc_query_iterator_t *iterator, char **key,
+                       size_t *key_len, char **value, size_t *value_len)
+{
+  const char *end = iterator->query + iterator->query_len;
+  while (iterator->pos < iterator->query_len) {
+    char *start = (char *)iterator->query + iterator->pos;
+    char *amp = memchr(start, '&', (size_t)(end - start));
+    char *pair_end = amp ? amp : (char *)end;
+    char *eq = memchr(start, '=', (size_t)(pair_end - start));
+    iterator->pos = (size_t)(pair_end - iterator->query) + 1;
+    /* Pairs without a value are skipped. */
+    if (eq) {
+      *key = start;
+      *key_len = (size_t)(eq - start);
+      *value = eq + 1;
+      *value_len = (size_t)(pair_end - *value);
+      return (int)iterator->pos;
+    }
+  }
+  return -1;
 }
 
 bool
-oc_iterate_query_get_values(oc_request_t *request, const char *key,
-                            char **value, int *value_len)
+oc_query_iterator_get_values(oc_query_iterator_t *iterator, const char *key,
+                             char **value, int *value_len)
 {
   char *current_key = 0;
-  size_t key_len = 0, v_len;
+  size_t key_len = 0, v_len = 0, len = strlen(key);
   int pos = 0;
 
   do {
-    pos = oc_iterate_query(request, &current_key, &key_len, value, &v_len);
+    pos = oc_query_iterator_next(iterator, &current_key, &key_len, value,
+                                 &v_len);
     *value_len = (int)v_len;
-    if (pos != -1 && strlen(key) == key_len &&
-        memcmp(key, current_key, key_len) == 0) {
+    if (pos != -1 && len == key_len && memcmp(key, current_key, key_len) == 0) {
       goto more_or_done;
     }
   } while (pos != -1);
@@ -159,12 +176,63 @@ oc_iterate_query_get_values(oc_request_t *request, const char *key,
   *value_len = -1;
 
 more_or_done:
-  if (pos == -1 || (size_t)pos >= request->query_len) {
+  if (pos == -1 || (size_t)pos >= iterator->query_len) {
     return false;
   }
   return true;
 }
 
+int
+oc_iterate_query_get_all_values(const oc_request_t *request,
+                                const char *const *keys, size_t num_keys,
+                                oc_query_value_cb_t cb, void *data)
+{
+  oc_query_iterator_t iterator;
+  char *key = 0, *value = 0;
+  size_t key_len = 0, value_len = 0, i;
+  int found = 0;
+
+  oc_query_iterator_init(&iterator, request);
+  while (oc_query_iterator_next(&iterator, &key, &key_len, &value,
+                                &value_len) != -1) {
+    for (i = 0; i < num_keys; i++) {
+      if (strlen(keys[i]) == key_len && memcmp(keys[i], key, key_len) == 0) {
+        found++;
+        if (cb) {
+          cb(i, value, value_len, data);
+        }
+        break;
+      }
+    }
+  }
+  return found;
+}
+
+void
+oc_init_query_iterator(void)
+{
+  query_iterator.pos = 0;
+}
+
+int
+oc_iterate_query(oc_request_t *request, char **key, size_t *key_len,
+                 char **value, size_t *value_len)
+{
+  query_iterator.query = request->query;
+  query_iterator.query_len = request->query ? request->query_len : 0;
+  return oc_query_iterator_next(&query_iterator, key, key_len, value,
+                                value_len);
+}
+
+bool
+oc_iterate_query_get_values(oc_request_t *request, const char *key,
+                            char **value, int *value_len)
+{
+  query_iterator.query = request->query;
+  query_iterator.query_len = request->query ? request->query_len : 0;
+  return oc_query_iterator_get_values(&query_iterator, key, value, value_len);
+}
+
 #ifdef OC_SERVER
 
 static void
@@ -291,6 +359,27 @@ oc_resource_set_periodic_observable(oc_resource_t *resource, uint16_t seconds)
   resource->observe_period_seconds = seconds;
 }
 
+void
+oc_resource_set_request_coalescing(oc_resource_t *resource, bool state)
+{
+  resource->coalesce_requests = state;
+}
+
+void
+oc_resource_set_response_cache(oc_resource_t *resource, uint16_t ttl_seconds)
+{
+  resource->response_cache_ttl = ttl_seconds;
+  if (ttl_seconds == 0) {
+    oc_ri_invalidate_cached_responses(resource);
+  }
+}
+
+void
+oc_resource_invalidate_response_cache(oc_resource_t *resource)
+{
+  oc_ri_invalidate_cached_responses(resource);
+}
+
 void
 oc_resource_set_properties_cbs(oc_resource_t *resource,
                                oc_get_properties_cb_t get_properties,
@@ -348,6 +437,18 @@ oc_add_resource(oc_resource_t *resource)
   return oc_ri_add_resource(resource);
 }
 
+void
+oc_resources_begin_batch(void)
+{
+  oc_ri_begin_resource_batch();
+}
+
+bool
+oc_resources_commit_batch(void)
+{
+  return oc_ri_commit_resource_batch();
+}
+
 bool
 oc_delete_resource(oc_resource_t *resource)
 {
@@ -365,6 +466,11 @@ oc_indicate_separate_response(oc_request_t *request,
 void
 oc_set_separate_response_buffer(oc_separate_response_t *handle)
 {
+#ifdef OC_COLLECTIONS
+  if (oc_collection_batch_set_buffer(handle)) {
+    return;
+  }
+#endif /* OC_COLLECTIONS */
 #ifdef OC_BLOCK_WISE
   oc_rep_new(handle->buffer, OC_MAX_APP_DATA_SIZE);
 #else  /* OC_BLOCK_WISE */
@@ -380,10 +486,35 @@ oc_send_separate_response(oc_separate_response_t *handle,
   response_buffer.buffer = handle->buffer;
   response_buffer.response_length = (uint16_t)response_length();
   response_buffer.code = oc_status_code(response_code);
+#ifdef OC_COLLECTIONS
+  /* Deliver into a pending batch response if the handle belongs to a
+   * deferred collection link.
+   */
+  int batch_length = oc_collection_batch_send(handle);
+  if (batch_length >= 0) {
+    response_buffer.response_length =
+      (uint16_t)((batch_length <= 2) ? 0 : batch_length);
+  }
+#endif /* OC_COLLECTIONS */
 
   coap_separate_t *cur = oc_list_head(handle->requests), *next = NULL;
   coap_packet_t response[1];
 
+  /* Deferred updates only take effect now, so drop the responses cached
+   * for their resources. */
+  if (response_buffer.code < oc_status_code(OC_STATUS_BAD_REQUEST)) {
+    for (; cur != NULL; cur = cur->next) {
+      if (cur->method != OC_GET) {
+        oc_resource_t *resource = oc_ri_get_app_resource_by_uri(
+          oc_string(cur->uri), oc_string_len(cur->uri), cur->endpoint.device);
+        if (resource) {
+          oc_ri_invalidate_cached_responses(resource);
+        }
+      }
+    }
+    cur = oc_list_head(handle->requests);
+  }
+
   while (cur != NULL) {
     next = cur->next;
     if (cur->observe > 0) {
@@ -471,6 +602,7 @@ oc_send_separate_response(oc_separate_response_t *handle,
     cur = next;
   }
   handle->active = 0;
+  oc_ri_release_coalesced_gets(handle);
 #ifdef OC_DYNAMIC_ALLOCATION
   free(handle->buffer);
 #endif /* OC_DYNAMIC_ALLOCATION */
@@ -479,6 +611,7 @@ oc_send_separate_response(oc_separate_response_t *handle,
 int
 oc_notify_observers(oc_resource_t *resource)
 {
+  oc_ri_invalidate_cached_responses(resource);
   return coap_notify_observers(resource, NULL, NULL);
 }
 #endif /* OC_SERVER */
@@ -0,0 +1,250 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#ifdef OC_TRACE
+#include "oc_trace.h"
+#include "port/oc_clock.h"
+#include "port/oc_connectivity.h"
+#include <string.h>
+#include <time.h>
+
+/* Must be a power of two. */
+#ifndef OC_TRACE_BUFFER_SIZE
+#define OC_TRACE_BUFFER_SIZE (1024)
+#endif /* !OC_TRACE_BUFFER_SIZE */
+
+/* Trace points fire on both the network thread (recv_msg, oc_network_event)
+ * and the event loop. Writers claim a slot with a relaxed fetch-and-add and
+ * publish it by storing its sequence number last; readers copy a slot and
+ * keep it only if the sequence number was unchanged across the copy.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define TRACE_CLAIM(var) __atomic_fetch_add(&(var), 1, __ATOMIC_RELAXED)
+#define TRACE_LOAD(var) __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define TRACE_STORE(var, val) __atomic_store_n(&(var), (val), __ATOMIC_RELEASE)
+#define TRACE_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else /* __GNUC__ || __clang__ */
+#define TRACE_CLAIM(var) ((var)++)
+#define TRACE_LOAD(var) (var)
+#define TRACE_STORE(var, val) ((var) = (val))
+#define TRACE_FENCE()
+#endif /* !__GNUC__ && !__clang__ */
+
+typedef struct
+{
+  uint32_t seq;
+  oc_trace_event_t event;
+} trace_slot_t;
+
+static trace_slot_t trace_ring[OC_TRACE_BUFFER_SIZE];
+static uint32_t trace_head;
+
+static const char *stage_names[OC_TRACE_NUM_STAGES] = {
+  "recv_msg",       "oc_network_event", "oc_recv_message",
+  "tls_decrypt",    "coap_receive",     "entity_handler",
+  "entity_handler", "coap_serialize",   "send_msg"
+};
+
+static uint64_t
+trace_time_ns(void)
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec t;
+  if (clock_gettime(CLOCK_MONOTONIC, &t) == 0) {
+    return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+  }
+#endif /* CLOCK_MONOTONIC */
+  return (uint64_t)oc_clock_time() * (1000000000ULL / OC_CLOCK_SECOND);
+}
+
+void
+oc_trace_event(oc_trace_stage_t stage, uint16_t mid, const uint8_t *token,
+               size_t token_len)
+{
+  uint32_t idx = TRACE_CLAIM(trace_head);
+  trace_slot_t *slot = &trace_ring[idx & (OC_TRACE_BUFFER_SIZE - 1)];
+
+  TRACE_STORE(slot->seq, 0);
+  TRACE_FENCE();
+  slot->event.timestamp_ns = trace_time_ns();
+  slot->event.stage = (uint8_t)stage;
+  slot->event.mid = mid;
+  if (token_len > sizeof(slot->event.token)) {
+    token_len = sizeof(slot->event.token);
+  }
+  slot->event.token_len = (uint8_t)token_len;
+  if (token && token_len > 0) {
+    memcpy(slot->event.token, token, token_len);
+  }
+  TRACE_STORE(slot->seq, idx + 1);
+}
+
+/* Peeks at the CoAP header of a raw message. Encrypted records carry no
+ * readable header, so they are traced without a message ID or token.
+ */
+void
+oc_trace_message(oc_trace_stage_t stage, const struct oc_message_s *message)
+{
+  const uint8_t *data = message->data;
+  size_t len = message->length;
+  uint16_t mid = 0;
+  size_t token_len = 0;
+  const uint8_t *token = NULL;
+
+#ifdef OC_SECURITY
+  if (message->encrypted) {
+    len = 0;
+  }
+#endif /* OC_SECURITY */
+#ifdef OC_TCP
+  if (message->endpoint.flags & TCP) {
+    if (len > 0) {
+      /* Len(4) TKL(4) [extended length] Code Token */
+      uint8_t tcp_len = data[0] >> 4;
+      size_t offset = 2 + (tcp_len < 13 ? 0 : (size_t)1 << (tcp_len - 13));
+      token_len = data[0] & 0x0F;
+      if (offset + token_len <= len) {
+        token = data + offset;
+      } else {
+        token_len = 0;
+      }
+    }
+  } else
+#endif /* OC_TCP */
+    if (len >= 4) {
+    /* Ver(2) T(2) TKL(4) Code MID(16) Token */
+    mid = (uint16_t)(data[2] << 8 | data[3]);
+    token_len = data[0] & 0x0F;
+    if (4 + token_len <= len) {
+      token = data + 4;
+    } else {
+      token_len = 0;
+    }
+  }
+  oc_trace_event(stage, mid, token, token_len);
+}
+
+size_t
+oc_trace_read(oc_trace_event_t *events, size_t max_events)
+{
+  uint32_t head = TRACE_LOAD(trace_head);
+  uint32_t idx =
+    (head > OC_TRACE_BUFFER_SIZE) ? head - OC_TRACE_BUFFER_SIZE : 0;
+  size_t n = 0;
+
+  for (; idx != head && n < max_events; idx++) {
+    trace_slot_t *slot = &trace_ring[idx & (OC_TRACE_BUFFER_SIZE - 1)];
+    uint32_t seq = TRACE_LOAD(slot->seq);
+    if (seq != idx + 1) {
+      continue;
+    }
+    memcpy(&events[n], &slot->event, sizeof(oc_trace_event_t));
+    TRACE_FENCE();
+    if (TRACE_LOAD(slot->seq) == seq) {
+      n++;
+    }
+  }
+  return n;
+}
+
+void
+oc_trace_clear(void)
+{
+  uint32_t i;
+  for (i = 0; i < OC_TRACE_BUFFER_SIZE; i++) {
+    TRACE_STORE(trace_ring[i].seq, 0);
+  }
+}
+
+const char *
+oc_trace_stage_name(oc_trace_stage_t stage)
+{
+  if (stage < OC_TRACE_NUM_STAGES) {
+    return stage_names[stage];
+  }
+  return NULL;
+}
+
+static void
+print_token(FILE *out, const oc_trace_event_t *e)
+{
+  uint8_t i;
+  for (i = 0; i < e->token_len; i++) {
+    fprintf(out, "%02x", e->token[i]);
+  }
+}
+
+static size_t
+read_all(oc_trace_event_t **events)
+{
+  static oc_trace_event_t snapshot[OC_TRACE_BUFFER_SIZE];
+  *events = snapshot;
+  return oc_trace_read(snapshot, OC_TRACE_BUFFER_SIZE);
+}
+
+int
+oc_trace_dump_chrome(FILE *out)
+{
+  oc_trace_event_t *events;
+  size_t n = read_all(&events), i;
+
+  fprintf(out, "{\"traceEvents\":[");
+  for (i = 0; i < n; i++) {
+    const oc_trace_event_t *e = &events[i];
+    const char *ph = "i";
+    if (e->stage == OC_TRACE_HANDLER_BEGIN) {
+      ph = "B";
+    } else if (e->stage == OC_TRACE_HANDLER_END) {
+      ph = "E";
+    }
+    fprintf(out,
+            "%s\n{\"name\":\"%s\",\"cat\":\"oc\",\"ph\":\"%s\",\"s\":\"t\","
+            "\"ts\":%llu.%03u,\"pid\":0,\"tid\":0,\"args\":{\"mid\":%u,"
+            "\"token\":\"",
+            (i > 0) ? "," : "", stage_names[e->stage], ph,
+            (unsigned long long)(e->timestamp_ns / 1000),
+            (unsigned)(e->timestamp_ns % 1000), e->mid);
+    print_token(out, e);
+    fprintf(out, "\"}}");
+  }
+  fprintf(out, "\n]}\n");
+  return ferror(out) ? -1 : 0;
+}
+
+int
+oc_trace_dump_text(FILE *out)
+{
+  oc_trace_event_t *events;
+  size_t n = read_all(&events), i;
+
+  for (i = 0; i < n; i++) {
+    const oc_trace_event_t *e = &events[i];
+    fprintf(out, "%llu.%09u %s%s mid=%u token=",
+            (unsigned long long)(e->timestamp_ns / 1000000000ULL),
+            (unsigned)(e->timestamp_ns % 1000000000ULL),
+            stage_names[e->stage],
+            (e->stage == OC_TRACE_HANDLER_BEGIN)
+              ? ":begin"
+              : (e->stage == OC_TRACE_HANDLER_END) ? ":end" : "",
+            e->mid);
+    print_token(out, e);
+    fputc('\n', out);
+  }
+  return ferror(out) ? -1 : 0;
+}
+#else  /* OC_TRACE */
+typedef int dummy_declaration;
+#endif /* !OC_TRACE */
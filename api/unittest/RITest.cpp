@@ -141,3 +141,101 @@ TEST_F(TestOcRi, RiAddResource_P)
     EXPECT_EQ(res_check, 1);
     oc_ri_delete_resource(res);
 }
+
+static oc_resource_t *newBatchResource(const char *uri)
+{
+    oc_resource_t *res = oc_new_resource(NULL, uri, 1, 0);
+    oc_resource_set_request_handler(res, OC_GET, onGet, NULL);
+    return res;
+}
+
+TEST_F(TestOcRi, RiCommitResourceBatch_P)
+{
+    oc_resource_t *a = newBatchResource("/a");
+    oc_resource_t *b = newBatchResource("/b");
+    oc_resource_t *c = newBatchResource("/c");
+
+    oc_ri_begin_resource_batch();
+    EXPECT_TRUE(oc_ri_add_resource(a));
+    EXPECT_TRUE(oc_ri_add_resource(b));
+    EXPECT_TRUE(oc_ri_add_resource(c));
+    EXPECT_EQ(NULL, oc_ri_get_app_resources());
+
+    EXPECT_TRUE(oc_ri_commit_resource_batch());
+    oc_resource_t *res = oc_ri_get_app_resources();
+    ASSERT_EQ(a, res);
+    ASSERT_EQ(b, res->next);
+    ASSERT_EQ(c, res->next->next);
+    EXPECT_EQ(NULL, res->next->next->next);
+
+    oc_ri_delete_resource(a);
+    oc_ri_delete_resource(b);
+    oc_ri_delete_resource(c);
+}
+
+TEST_F(TestOcRi, RiCommitResourceBatchAfterTail_P)
+{
+    oc_resource_t *a = newBatchResource("/a");
+    oc_resource_t *b = newBatchResource("/b");
+    oc_resource_t *c = newBatchResource("/c");
+    EXPECT_TRUE(oc_ri_add_resource(a));
+
+    oc_ri_begin_resource_batch();
+    EXPECT_TRUE(oc_ri_add_resource(b));
+    EXPECT_TRUE(oc_ri_add_resource(c));
+
+    EXPECT_TRUE(oc_ri_commit_resource_batch());
+    oc_resource_t *res = oc_ri_get_app_resources();
+    ASSERT_EQ(a, res);
+    ASSERT_EQ(b, res->next);
+    ASSERT_EQ(c, res->next->next);
+
+    oc_ri_delete_resource(a);
+    oc_ri_delete_resource(b);
+    oc_ri_delete_resource(c);
+}
+
+TEST_F(TestOcRi, RiCommitResourceBatchDeleteTail_P)
+{
+    oc_resource_t *a = newBatchResource("/a");
+    oc_resource_t *b = newBatchResource("/b");
+    oc_resource_t *c = newBatchResource("/c");
+
+    oc_ri_begin_resource_batch();
+    EXPECT_TRUE(oc_ri_add_resource(a));
+    EXPECT_TRUE(oc_ri_add_resource(b));
+    oc_ri_delete_resource(b);
+    EXPECT_TRUE(oc_ri_add_resource(c));
+
+    EXPECT_TRUE(oc_ri_commit_resource_batch());
+    oc_resource_t *res = oc_ri_get_app_resources();
+    ASSERT_EQ(a, res);
+    ASSERT_EQ(c, res->next);
+    EXPECT_EQ(NULL, res->next->next);
+
+    oc_ri_delete_resource(a);
+    oc_ri_delete_resource(c);
+}
+
+TEST_F(TestOcRi, RiCommitResourceBatch_N)
+{
+    oc_resource_t *a = newBatchResource("/a");
+    oc_resource_t *b = newBatchResource("/b");
+    oc_resource_t *dup = newBatchResource("/a");
+    EXPECT_TRUE(oc_ri_add_resource(a));
+
+    oc_ri_begin_resource_batch();
+    EXPECT_TRUE(oc_ri_add_resource(b));
+    EXPECT_TRUE(oc_ri_add_resource(dup));
+
+    EXPECT_FALSE(oc_ri_commit_resource_batch());
+    oc_resource_t *res = oc_ri_get_app_resources();
+    ASSERT_EQ(a, res);
+    EXPECT_EQ(NULL, res->next);
+    EXPECT_EQ(NULL, b->next);
+    EXPECT_EQ(NULL, dup->next);
+
+    oc_ri_delete_resource(a);
+    oc_ri_delete_resource(b);
+    oc_ri_delete_resource(dup);
+}
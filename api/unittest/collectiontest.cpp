@@ -0,0 +1,130 @@
+/******************************************************************
+ *
+ * Copyright 2026 The IoTivity-Lite Authors All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <gtest/gtest.h>
+
+#include "oc_api.h"
+#include "oc_collection.h"
+#include "oc_ri.h"
+
+#define RESOURCE_URI "/LightResourceURI"
+#define COLLECTION_A_URI "/CollectionA"
+#define COLLECTION_B_URI "/CollectionB"
+#define MAX_COLLECTIONS 8
+
+class TestCollection : public testing::Test
+{
+protected:
+  virtual void SetUp() { oc_ri_init(); }
+  virtual void TearDown() { oc_ri_shutdown(); }
+
+  static oc_resource_t *NewResource(void)
+  {
+    oc_resource_t *res = oc_new_resource(NULL, RESOURCE_URI, 1, 0);
+    oc_resource_bind_resource_type(res, "oic.r.light");
+    oc_resource_set_request_handler(res, OC_GET, onGet, NULL);
+    oc_ri_add_resource(res);
+    return res;
+  }
+
+  static oc_resource_t *NewCollection(const char *uri)
+  {
+    oc_resource_t *col = oc_new_collection(NULL, uri, 1, 0);
+    oc_resource_bind_resource_type(col, "oic.wk.col");
+    oc_add_collection(col);
+    return col;
+  }
+
+  /* Collects the collections linking to res, stopping after
+   * MAX_COLLECTIONS so that a looping iteration fails instead of hanging. */
+  static int CollectionsWithLink(oc_resource_t *res,
+                                 oc_collection_t **found)
+  {
+    int n = 0;
+    oc_collection_t *c = oc_get_next_collection_with_link(res, NULL);
+    while (c != NULL && n < MAX_COLLECTIONS) {
+      found[n++] = c;
+      c = oc_get_next_collection_with_link(res, c);
+    }
+    return n;
+  }
+
+  static void onGet(oc_request_t *request, oc_interface_mask_t iface_mask,
+                    void *user_data)
+  {
+    (void)request;
+    (void)iface_mask;
+    (void)user_data;
+  }
+};
+
+TEST_F(TestCollection, NextCollectionWithLink_P)
+{
+  oc_resource_t *res = NewResource();
+  oc_resource_t *a = NewCollection(COLLECTION_A_URI);
+  oc_resource_t *b = NewCollection(COLLECTION_B_URI);
+  oc_collection_add_link(a, oc_new_link(res));
+  oc_collection_add_link(b, oc_new_link(res));
+
+  oc_collection_t *found[MAX_COLLECTIONS];
+  ASSERT_EQ(2, CollectionsWithLink(res, found));
+  EXPECT_EQ((oc_collection_t *)a, found[0]);
+  EXPECT_EQ((oc_collection_t *)b, found[1]);
+}
+
+TEST_F(TestCollection, NextCollectionWithLink_N)
+{
+  oc_resource_t *res = NewResource();
+  NewCollection(COLLECTION_A_URI);
+
+  EXPECT_EQ(NULL, oc_get_next_collection_with_link(res, NULL));
+}
+
+TEST_F(TestCollection, NextCollectionWithDuplicateInterleavedLinks_P)
+{
+  oc_resource_t *res = NewResource();
+  oc_resource_t *a = NewCollection(COLLECTION_A_URI);
+  oc_resource_t *b = NewCollection(COLLECTION_B_URI);
+  /* Leaves the links of a on both sides of the link of b in the index. */
+  oc_collection_add_link(a, oc_new_link(res));
+  oc_collection_add_link(b, oc_new_link(res));
+  oc_collection_add_link(a, oc_new_link(res));
+
+  oc_collection_t *found[MAX_COLLECTIONS];
+  ASSERT_EQ(2, CollectionsWithLink(res, found));
+  EXPECT_EQ((oc_collection_t *)a, found[0]);
+  EXPECT_EQ((oc_collection_t *)b, found[1]);
+}
+
+TEST_F(TestCollection, NextCollectionWithLinkAfterRemove_P)
+{
+  oc_resource_t *res = NewResource();
+  oc_resource_t *a = NewCollection(COLLECTION_A_URI);
+  oc_resource_t *b = NewCollection(COLLECTION_B_URI);
+  oc_link_t *link = oc_new_link(res);
+  oc_collection_add_link(a, link);
+  oc_collection_add_link(b, oc_new_link(res));
+  oc_collection_remove_link(a, link);
+  oc_delete_link(link);
+
+  oc_collection_t *found[MAX_COLLECTIONS];
+  ASSERT_EQ(1, CollectionsWithLink(res, found));
+  EXPECT_EQ((oc_collection_t *)b, found[0]);
+}
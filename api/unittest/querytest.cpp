@@ -0,0 +1,177 @@
+/******************************************************************
+ *
+ * Copyright 2026 The IoTivity-Lite Authors All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "oc_api.h"
+
+#define QUERY "a=1&b=2&a=3"
+
+class TestQueryIterator : public testing::Test
+{
+protected:
+  virtual void SetUp()
+  {
+    memset(&m_request, 0, sizeof(m_request));
+    SetQuery(QUERY);
+  }
+
+  void SetQuery(const char *query)
+  {
+    m_request.query = query;
+    m_request.query_len = query ? strlen(query) : 0;
+  }
+
+  static std::string Pair(const char *key, size_t key_len, const char *value,
+                          size_t value_len)
+  {
+    return std::string(key, key_len) + "=" + std::string(value, value_len);
+  }
+
+  static void onValue(size_t key_index, const char *value, size_t value_len,
+                      void *data)
+  {
+    std::vector<std::string> *found = (std::vector<std::string> *)data;
+    found->push_back(std::to_string(key_index) + ":" +
+                     std::string(value, value_len));
+  }
+
+  oc_request_t m_request;
+};
+
+TEST_F(TestQueryIterator, Next_P)
+{
+  oc_query_iterator_t it;
+  char *key, *value;
+  size_t key_len, value_len;
+  std::vector<std::string> pairs;
+
+  oc_query_iterator_init(&it, &m_request);
+  while (oc_query_iterator_next(&it, &key, &key_len, &value, &value_len) !=
+         -1) {
+    pairs.push_back(Pair(key, key_len, value, value_len));
+  }
+
+  ASSERT_EQ(3u, pairs.size());
+  EXPECT_EQ("a=1", pairs[0]);
+  EXPECT_EQ("b=2", pairs[1]);
+  EXPECT_EQ("a=3", pairs[2]);
+}
+
+TEST_F(TestQueryIterator, NextWithoutQuery_N)
+{
+  oc_query_iterator_t it;
+  char *key, *value;
+  size_t key_len, value_len;
+
+  SetQuery(NULL);
+  oc_query_iterator_init(&it, &m_request);
+  EXPECT_EQ(-1,
+            oc_query_iterator_next(&it, &key, &key_len, &value, &value_len));
+}
+
+TEST_F(TestQueryIterator, NextSkipsPairsWithoutValue_P)
+{
+  oc_query_iterator_t it;
+  char *key, *value;
+  size_t key_len, value_len;
+
+  SetQuery("flag&b=2");
+  oc_query_iterator_init(&it, &m_request);
+  ASSERT_NE(-1,
+            oc_query_iterator_next(&it, &key, &key_len, &value, &value_len));
+  EXPECT_EQ("b=2", Pair(key, key_len, value, value_len));
+  EXPECT_EQ(-1,
+            oc_query_iterator_next(&it, &key, &key_len, &value, &value_len));
+}
+
+TEST_F(TestQueryIterator, Nested_P)
+{
+  oc_query_iterator_t outer, inner;
+  char *key, *value;
+  size_t key_len, value_len;
+  std::vector<std::string> pairs;
+
+  oc_query_iterator_init(&outer, &m_request);
+  while (oc_query_iterator_next(&outer, &key, &key_len, &value, &value_len) !=
+         -1) {
+    std::string outer_pair = Pair(key, key_len, value, value_len);
+    oc_query_iterator_init(&inner, &m_request);
+    while (oc_query_iterator_next(&inner, &key, &key_len, &value,
+                                  &value_len) != -1) {
+      pairs.push_back(outer_pair + "," + Pair(key, key_len, value, value_len));
+    }
+  }
+
+  ASSERT_EQ(9u, pairs.size());
+  EXPECT_EQ("a=1,a=1", pairs[0]);
+  EXPECT_EQ("b=2,a=3", pairs[5]);
+  EXPECT_EQ("a=3,a=3", pairs[8]);
+}
+
+TEST_F(TestQueryIterator, GetValues_P)
+{
+  oc_query_iterator_t it;
+  char *value;
+  int value_len;
+
+  oc_query_iterator_init(&it, &m_request);
+  EXPECT_TRUE(oc_query_iterator_get_values(&it, "a", &value, &value_len));
+  ASSERT_EQ(1, value_len);
+  EXPECT_EQ('1', value[0]);
+  EXPECT_FALSE(oc_query_iterator_get_values(&it, "a", &value, &value_len));
+  ASSERT_EQ(1, value_len);
+  EXPECT_EQ('3', value[0]);
+}
+
+TEST_F(TestQueryIterator, GetValues_N)
+{
+  oc_query_iterator_t it;
+  char *value;
+  int value_len;
+
+  oc_query_iterator_init(&it, &m_request);
+  EXPECT_FALSE(oc_query_iterator_get_values(&it, "c", &value, &value_len));
+  EXPECT_EQ(-1, value_len);
+}
+
+TEST_F(TestQueryIterator, GetAllValues_P)
+{
+  const char *const keys[] = { "b", "a" };
+  std::vector<std::string> found;
+
+  EXPECT_EQ(3, oc_iterate_query_get_all_values(&m_request, keys, 2, onValue,
+                                               &found));
+  ASSERT_EQ(3u, found.size());
+  EXPECT_EQ("1:1", found[0]);
+  EXPECT_EQ("0:2", found[1]);
+  EXPECT_EQ("1:3", found[2]);
+}
+
+TEST_F(TestQueryIterator, GetAllValues_N)
+{
+  const char *const keys[] = { "c" };
+
+  EXPECT_EQ(0,
+            oc_iterate_query_get_all_values(&m_request, keys, 1, NULL, NULL));
+}
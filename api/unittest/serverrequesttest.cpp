@@ -0,0 +1,397 @@
+/******************************************************************
+ *
+ * Copyright 2026 The IoTivity-Lite Authors All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "messaging/coap/coap.h"
+#include "messaging/coap/oc_coap.h"
+#include "messaging/coap/separate.h"
+#include "oc_api.h"
+#include "oc_blockwise.h"
+
+#ifdef OC_SECURITY
+#include "security/oc_acl_internal.h"
+#include "security/oc_pstat.h"
+#endif /* OC_SECURITY */
+
+#define RESOURCE_URI "/LightResourceURI"
+
+#ifdef OC_BLOCK_WISE
+extern "C" bool oc_ri_invoke_coap_entity_handler(
+  void *request, void *response, oc_blockwise_state_t **request_state,
+  oc_blockwise_state_t **response_state, uint16_t block2_size,
+  oc_endpoint_t *endpoint);
+#else  /* OC_BLOCK_WISE */
+extern "C" bool oc_ri_invoke_coap_entity_handler(void *request, void *response,
+                                                 uint8_t *buffer,
+                                                 oc_endpoint_t *endpoint);
+#endif /* !OC_BLOCK_WISE */
+
+static int appInit(void)
+{
+  int ret = oc_init_platform("IoTivity", NULL, NULL);
+  ret |= oc_add_device("/oic/d", "oic.d.light", "Lamp", "ocf.1.0.0",
+                       "ocf.res.1.0.0", NULL, NULL);
+  return ret;
+}
+
+static void signalEventLoop(void)
+{
+}
+
+static oc_handler_t handler = {.init = appInit,
+                               .signal_event_loop = signalEventLoop,
+                               .register_resources = NULL,
+                               .requests_entry = NULL };
+
+class TestServerRequest : public testing::Test
+{
+protected:
+  static void SetUpTestCase()
+  {
+    oc_main_init(&handler);
+#ifdef OC_SECURITY
+    allowAnonAccess();
+#endif /* OC_SECURITY */
+  }
+  static void TearDownTestCase() { oc_main_shutdown(); }
+
+#ifdef OC_SECURITY
+  /* Puts the device in RFNOP with an anon-clear ACE for the test resource,
+   * so that the unsecured test requests pass access control. */
+  static void allowAnonAccess(void)
+  {
+    uint8_t buffer[256];
+    oc_rep_new(buffer, sizeof(buffer));
+    oc_rep_start_root_object();
+    oc_rep_set_array(root, aclist2);
+    oc_rep_object_array_start_item(aclist2);
+    oc_rep_set_int(aclist2, aceid, 1);
+    oc_rep_set_int(aclist2, permission, OC_PERM_RETRIEVE | OC_PERM_UPDATE);
+    oc_rep_set_object(aclist2, subject);
+    oc_rep_set_text_string(subject, conntype, "anon-clear");
+    oc_rep_close_object(aclist2, subject);
+    oc_rep_set_array(aclist2, resources);
+    oc_rep_object_array_start_item(resources);
+    oc_rep_set_text_string(resources, href, RESOURCE_URI);
+    oc_rep_object_array_end_item(resources);
+    oc_rep_close_array(aclist2, resources);
+    oc_rep_object_array_end_item(aclist2);
+    oc_rep_close_array(root, aclist2);
+    oc_rep_end_root_object();
+
+    oc_rep_t *rep = NULL;
+    ASSERT_EQ(0, oc_parse_rep(buffer, oc_rep_get_encoded_payload_size(), &rep));
+    ASSERT_TRUE(oc_sec_decode_acl(rep, true, 0));
+    oc_free_rep(rep);
+    oc_sec_get_pstat(0)->s = OC_DOS_RFNOP;
+  }
+#endif /* OC_SECURITY */
+
+  virtual void SetUp()
+  {
+    s_getCount = 0;
+    s_deferGet = false;
+    s_completeFromThread = false;
+    memset(&s_handle, 0, sizeof(s_handle));
+    OC_LIST_STRUCT_INIT(&s_handle, requests);
+
+    s_resource = oc_new_resource(NULL, RESOURCE_URI, 1, 0);
+    oc_resource_bind_resource_type(s_resource, "oic.r.light");
+    oc_resource_bind_resource_interface(s_resource, OC_IF_RW);
+    oc_resource_set_default_interface(s_resource, OC_IF_RW);
+    oc_resource_set_request_handler(s_resource, OC_GET, onGet, NULL);
+    oc_resource_set_request_handler(s_resource, OC_POST, onPost, NULL);
+    oc_add_resource(s_resource);
+  }
+
+  virtual void TearDown()
+  {
+    if (s_completer.joinable()) {
+      s_completer.join();
+    }
+    oc_ri_release_coalesced_gets(&s_handle);
+    coap_separate_t *cur = (coap_separate_t *)oc_list_head(s_handle.requests);
+    while (cur != NULL) {
+      coap_separate_clear(&s_handle, cur);
+      cur = (coap_separate_t *)oc_list_head(s_handle.requests);
+    }
+#ifdef OC_DYNAMIC_ALLOCATION
+    free(s_handle.buffer);
+#endif /* OC_DYNAMIC_ALLOCATION */
+    s_handle.active = 0;
+    oc_delete_resource(s_resource);
+  }
+
+  /* Hands a request with its own token and message ID to the resource
+   * layer, as the CoAP engine does for an incoming request, and returns the
+   * payload of the response. */
+  static std::vector<uint8_t> Invoke(coap_method_t method, const char *query,
+                                     uint16_t port = 5683)
+  {
+    static uint16_t mid;
+    ++mid;
+
+    oc_endpoint_t endpoint;
+    memset(&endpoint, 0, sizeof(endpoint));
+    endpoint.flags = IPV6;
+    endpoint.addr.ipv6.address[15] = 1;
+    endpoint.addr.ipv6.port = port;
+    endpoint.version = OCF_VER_1_0_0;
+
+    uint8_t token[2] = { (uint8_t)(mid >> 8), (uint8_t)mid };
+    coap_packet_t request[1], response[1];
+    coap_udp_init_message(request, COAP_TYPE_CON, method, mid);
+    coap_set_token(request, token, sizeof(token));
+    coap_set_header_uri_path(request, RESOURCE_URI, strlen(RESOURCE_URI));
+    if (query != NULL) {
+      coap_set_header_uri_query(request, query);
+    }
+    coap_udp_init_message(response, COAP_TYPE_ACK, CONTENT_2_05, mid);
+
+    std::vector<uint8_t> payload;
+#ifdef OC_BLOCK_WISE
+    oc_blockwise_state_t *request_state = NULL, *response_state = NULL;
+    oc_ri_invoke_coap_entity_handler(request, response, &request_state,
+                                     &response_state, OC_BLOCK_SIZE,
+                                     &endpoint);
+    if (request_state != NULL) {
+      oc_blockwise_free_request_buffer(request_state);
+    }
+    if (response_state != NULL) {
+      payload.assign(response_state->buffer,
+                     response_state->buffer + response_state->payload_size);
+      oc_blockwise_free_response_buffer(response_state);
+    }
+#else  /* OC_BLOCK_WISE */
+    uint8_t buffer[OC_MAX_APP_DATA_SIZE];
+    oc_ri_invoke_coap_entity_handler(request, response, buffer, &endpoint);
+    const uint8_t *data = NULL;
+    int len = coap_get_payload(response, &data);
+    if (len > 0) {
+      payload.assign(data, data + len);
+    }
+#endif /* !OC_BLOCK_WISE */
+    return payload;
+  }
+
+  static void onGet(oc_request_t *request, oc_interface_mask_t iface_mask,
+                    void *user_data)
+  {
+    (void)iface_mask;
+    (void)user_data;
+    ++s_getCount;
+    if (s_deferGet) {
+      oc_indicate_separate_response(request, &s_handle);
+      return;
+    }
+    if (s_completeFromThread) {
+      oc_deferred_request_t *deferred = oc_request_defer(request);
+      ASSERT_NE(nullptr, deferred);
+      s_completer = std::thread([deferred]() {
+        const uint8_t payload[] = { 0xA0 }; /* empty map */
+        EXPECT_EQ(0, oc_request_complete(deferred, OC_STATUS_OK, payload,
+                                         sizeof(payload)));
+      });
+      return;
+    }
+    oc_rep_start_root_object();
+    oc_rep_set_int(root, count, s_getCount);
+    oc_rep_end_root_object();
+    oc_send_response(request, OC_STATUS_OK);
+  }
+
+  static void onPost(oc_request_t *request, oc_interface_mask_t iface_mask,
+                     void *user_data)
+  {
+    (void)iface_mask;
+    (void)user_data;
+    oc_send_response(request, OC_STATUS_CHANGED);
+  }
+
+  static oc_resource_t *s_resource;
+  static oc_separate_response_t s_handle;
+  static int s_getCount;
+  static bool s_deferGet;
+  static bool s_completeFromThread;
+  static std::thread s_completer;
+};
+
+oc_resource_t *TestServerRequest::s_resource;
+oc_separate_response_t TestServerRequest::s_handle;
+int TestServerRequest::s_getCount;
+bool TestServerRequest::s_deferGet;
+bool TestServerRequest::s_completeFromThread;
+std::thread TestServerRequest::s_completer;
+
+TEST_F(TestServerRequest, CoalesceIdenticalGets_P)
+{
+  s_deferGet = true;
+  oc_resource_set_request_coalescing(s_resource, true);
+
+  Invoke(COAP_GET, "a=1");
+  Invoke(COAP_GET, "a=1");
+
+  EXPECT_EQ(1, s_getCount);
+  EXPECT_EQ(2, oc_list_length(s_handle.requests));
+}
+
+TEST_F(TestServerRequest, CoalesceDifferentQueries_N)
+{
+  s_deferGet = true;
+  oc_resource_set_request_coalescing(s_resource, true);
+
+  Invoke(COAP_GET, "a=1");
+  Invoke(COAP_GET, "a=2");
+
+  EXPECT_EQ(2, s_getCount);
+}
+
+TEST_F(TestServerRequest, CoalesceDisabled_N)
+{
+  s_deferGet = true;
+
+  Invoke(COAP_GET, "a=1");
+  Invoke(COAP_GET, "a=1");
+
+  EXPECT_EQ(2, s_getCount);
+}
+
+TEST_F(TestServerRequest, CoalesceAfterRelease_P)
+{
+  s_deferGet = true;
+  oc_resource_set_request_coalescing(s_resource, true);
+
+  Invoke(COAP_GET, "a=1");
+  oc_ri_release_coalesced_gets(&s_handle);
+  Invoke(COAP_GET, "a=1");
+
+  EXPECT_EQ(2, s_getCount);
+}
+
+TEST_F(TestServerRequest, ResponseCacheHit_P)
+{
+  oc_resource_set_response_cache(s_resource, 60);
+
+  Invoke(COAP_GET, NULL);
+  Invoke(COAP_GET, NULL);
+
+  EXPECT_EQ(1, s_getCount);
+}
+
+TEST_F(TestServerRequest, ResponseCachePayload_P)
+{
+  oc_resource_set_response_cache(s_resource, 60);
+
+  std::vector<uint8_t> encoded = Invoke(COAP_GET, NULL);
+  std::vector<uint8_t> cached = Invoke(COAP_GET, NULL);
+
+  EXPECT_EQ(1, s_getCount);
+  ASSERT_FALSE(encoded.empty());
+  EXPECT_EQ(encoded, cached);
+}
+
+TEST_F(TestServerRequest, ResponseCacheDisabled_N)
+{
+  Invoke(COAP_GET, NULL);
+  Invoke(COAP_GET, NULL);
+
+  EXPECT_EQ(2, s_getCount);
+}
+
+TEST_F(TestServerRequest, ResponseCacheDifferentQueries_N)
+{
+  oc_resource_set_response_cache(s_resource, 60);
+
+  Invoke(COAP_GET, "a=1");
+  Invoke(COAP_GET, "a=2");
+  Invoke(COAP_GET, "a=1");
+
+  EXPECT_EQ(2, s_getCount);
+}
+
+TEST_F(TestServerRequest, ResponseCacheInvalidate_P)
+{
+  oc_resource_set_response_cache(s_resource, 60);
+
+  Invoke(COAP_GET, NULL);
+  oc_resource_invalidate_response_cache(s_resource);
+  Invoke(COAP_GET, NULL);
+
+  EXPECT_EQ(2, s_getCount);
+}
+
+TEST_F(TestServerRequest, ResponseCacheInvalidatedByPost_P)
+{
+  oc_resource_set_response_cache(s_resource, 60);
+
+  Invoke(COAP_GET, NULL);
+  Invoke(COAP_POST, NULL);
+  Invoke(COAP_GET, NULL);
+
+  EXPECT_EQ(2, s_getCount);
+}
+
+TEST_F(TestServerRequest, DeferredRequestCompletedFromThread_P)
+{
+  /* Stands in for the client, to receive the separate response. */
+  int sock = socket(AF_INET6, SOCK_DGRAM, 0);
+  ASSERT_NE(-1, sock);
+  struct sockaddr_in6 addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin6_family = AF_INET6;
+  addr.sin6_addr = in6addr_loopback;
+  socklen_t addr_len = sizeof(addr);
+  ASSERT_EQ(0, bind(sock, (struct sockaddr *)&addr, sizeof(addr)));
+  ASSERT_EQ(0, getsockname(sock, (struct sockaddr *)&addr, &addr_len));
+  struct timeval timeout = { 1, 0 };
+  setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  s_completeFromThread = true;
+  Invoke(COAP_GET, NULL, ntohs(addr.sin6_port));
+  ASSERT_TRUE(s_completer.joinable());
+  s_completer.join();
+  oc_main_poll();
+
+  /* Skip the empty ACK of the confirmable request. */
+  coap_packet_t response[1];
+  uint8_t buffer[OC_PDU_SIZE];
+  ssize_t len;
+  do {
+    len = recv(sock, buffer, sizeof(buffer), 0);
+    ASSERT_GT(len, 0);
+    ASSERT_EQ(COAP_NO_ERROR,
+              coap_udp_parse_message(response, buffer, (uint16_t)len));
+  } while (response->code == 0);
+  close(sock);
+
+  EXPECT_EQ(CONTENT_2_05, response->code);
+  const uint8_t *payload = NULL;
+  ASSERT_EQ(1, coap_get_payload(response, &payload));
+  EXPECT_EQ(0xA0, payload[0]);
+}
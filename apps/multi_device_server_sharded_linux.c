@@ -0,0 +1,222 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+/* Hosts many light devices spread over several shards, each running its own
+ * stack instance on its own core. Switching a light on or off is announced
+ * to the other shards through the shard mailboxes.
+ *
+ * Usage: multi_device_server_sharded [num_shards [num_devices]]
+ */
+
+#include "oc_api.h"
+#include "oc_poll_fd.h"
+#include "oc_shard.h"
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#ifdef OC_DYNAMIC_ALLOCATION
+#define MAX_DEVICES_PER_SHARD (64)
+#else /* OC_DYNAMIC_ALLOCATION */
+#define MAX_DEVICES_PER_SHARD (OC_MAX_NUM_DEVICES)
+#endif /* !OC_DYNAMIC_ALLOCATION */
+
+static int num_shards = 4;
+static int num_devices = 16;
+static volatile sig_atomic_t quit = 0;
+static size_t num_local_devices;
+static bool light_state[MAX_DEVICES_PER_SHARD];
+
+/* Devices are assigned round robin: global device g lives on shard
+ * g % num_shards as local device g / num_shards.
+ */
+static int
+global_device_index(size_t device)
+{
+  return (int)device * num_shards + oc_shard_id();
+}
+
+static int
+app_init(void)
+{
+  char name[32];
+  int g, ret = oc_init_platform("Lighting bridge", NULL, NULL);
+  for (g = oc_shard_id(); g < num_devices; g += num_shards) {
+    snprintf(name, sizeof(name), "Light %d", g);
+    ret |= oc_add_device("/oic/d", "oic.d.light", name, "ocf.1.0.0",
+                         "ocf.res.1.0.0", NULL, NULL);
+    num_local_devices++;
+  }
+  return ret;
+}
+
+static void
+get_light(oc_request_t *request, oc_interface_mask_t iface_mask,
+          void *user_data)
+{
+  (void)user_data;
+  oc_rep_start_root_object();
+  switch (iface_mask) {
+  case OC_IF_BASELINE:
+    oc_process_baseline_interface(request->resource);
+  /* fall through */
+  case OC_IF_RW:
+    oc_rep_set_boolean(root, value, light_state[request->resource->device]);
+    break;
+  default:
+    break;
+  }
+  oc_rep_end_root_object();
+  oc_send_response(request, OC_STATUS_OK);
+}
+
+static void
+post_light(oc_request_t *request, oc_interface_mask_t iface_mask,
+           void *user_data)
+{
+  (void)iface_mask;
+  (void)user_data;
+  size_t device = request->resource->device;
+  bool value;
+  char message[64];
+  int shard, len;
+
+  if (!oc_rep_get_bool(request->request_payload, "value", &value)) {
+    oc_send_response(request, OC_STATUS_BAD_REQUEST);
+    return;
+  }
+  light_state[device] = value;
+  oc_send_response(request, OC_STATUS_CHANGED);
+
+  len = snprintf(message, sizeof(message), "light %d switched %s",
+                 global_device_index(device), value ? "on" : "off");
+  for (shard = 0; shard < num_shards; shard++) {
+    if (shard != oc_shard_id()) {
+      oc_shard_send(shard, message, (size_t)len);
+    }
+  }
+}
+
+static void
+register_resources(void)
+{
+  size_t device;
+  for (device = 0; device < num_local_devices; device++) {
+    oc_resource_t *res = oc_new_resource("light", "/a/light", 1, device);
+    oc_resource_bind_resource_type(res, "oic.r.switch.binary");
+    oc_resource_bind_resource_interface(res, OC_IF_RW);
+    oc_resource_set_default_interface(res, OC_IF_RW);
+    oc_resource_set_discoverable(res, true);
+    oc_resource_set_request_handler(res, OC_GET, get_light, NULL);
+    oc_resource_set_request_handler(res, OC_POST, post_light, NULL);
+    oc_add_resource(res);
+  }
+}
+
+static void
+handle_message(int from, const uint8_t *message, size_t length,
+               void *user_data)
+{
+  (void)user_data;
+  PRINT("shard %d: from shard %d: %.*s\n", oc_shard_id(), from, (int)length,
+        (const char *)message);
+}
+
+static void
+handle_signal(int signal)
+{
+  (void)signal;
+  quit = 1;
+}
+
+static int
+shard_main(int shard, void *data)
+{
+  (void)data;
+  struct sigaction sa;
+  sigfillset(&sa.sa_mask);
+  sa.sa_flags = 0;
+  sa.sa_handler = handle_signal;
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+
+  static const oc_handler_t handler = {.init = app_init,
+                                       .signal_event_loop = oc_poll_fd_signal,
+                                       .register_resources =
+                                         register_resources };
+
+#ifdef OC_STORAGE
+  char storage[64];
+  snprintf(storage, sizeof(storage), "./multi_device_server_sharded_creds/%d",
+           shard);
+  mkdir(storage, 0700);
+  oc_storage_config(storage);
+#else  /* OC_STORAGE */
+  (void)shard;
+#endif /* !OC_STORAGE */
+
+  int fd = oc_poll_fd_open();
+  if (fd < 0 || oc_main_init(&handler) < 0) {
+    return -1;
+  }
+
+  struct pollfd fds[2] = { { fd, POLLIN, 0 },
+                           { oc_shard_inbox_fd(), POLLIN, 0 } };
+  while (quit != 1) {
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    if (fds[0].revents & POLLIN) {
+      oc_poll_fd_dispatch();
+    }
+    if (fds[1].revents & POLLIN) {
+      oc_shard_receive(handle_message, NULL);
+    }
+  }
+
+  oc_main_shutdown();
+  oc_poll_fd_close();
+  return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+  if (argc > 1) {
+    num_shards = atoi(argv[1]);
+  }
+  if (argc > 2) {
+    num_devices = atoi(argv[2]);
+  }
+  if (num_shards <= 0 || num_shards > OC_MAX_NUM_SHARDS || num_devices <= 0 ||
+      (num_devices + num_shards - 1) / num_shards > MAX_DEVICES_PER_SHARD) {
+    PRINT("usage: %s [num_shards [num_devices]]\n"
+          "at most %d shards and %d devices per shard\n",
+          argv[0], OC_MAX_NUM_SHARDS, MAX_DEVICES_PER_SHARD);
+    return 1;
+  }
+  if (num_devices < num_shards) {
+    num_shards = num_devices;
+  }
+
+  return oc_shard_run(num_shards, shard_main, NULL) == 0 ? 0 : 1;
+}
@@ -892,6 +892,31 @@ bool oc_collection_add_supported_rt(oc_resource_t *collection, const char *rt);
 
 bool oc_collection_add_mandatory_rt(oc_resource_t *collection, const char *rt);
 
+/**
+  @brief Enables asynchronous handling of \c oic.if.b RETRIEVE requests.
+
+  By default the handlers of all linked resources are invoked one after
+  another and their results are embedded into a single response. With
+  asynchronous batch handling enabled, a link handler may defer its
+  response with \c oc_indicate_separate_response(). The collection then
+  answers the request as a separate response that is assembled as the
+  deferred handlers call \c oc_send_separate_response(). Links that have
+  not responded within \c timeout_seconds are left out of the response.
+  Deferred links may complete in any order, but each one must finish
+  encoding its representation before another link's
+  \c oc_set_separate_response_buffer() is called.
+  Builds without OC_DYNAMIC_ALLOCATION only handle batches asynchronously
+  when the port configuration defines OC_MAX_BATCH_RESPONSES, the number of
+  batch responses that may be pending at once.
+  @param collection Collection to configure. Does nothing if NULL.
+  @param timeout_seconds Per-request timeout for deferred links, or 0 to
+   disable asynchronous batch handling (default).
+  @see oc_indicate_separate_response
+  @see oc_send_separate_response
+*/
+void oc_collection_set_async_batch(oc_resource_t *collection,
+                                   uint16_t timeout_seconds);
+
 #ifdef OC_COLLECTIONS_IF_CREATE
 typedef oc_resource_t *(*oc_resource_get_instance_t)(const char *,
                                                      oc_string_array_t *,
@@ -965,6 +990,58 @@ void oc_resource_set_observable(oc_resource_t *resource, bool state);
 void oc_resource_set_periodic_observable(oc_resource_t *resource,
                                          uint16_t seconds);
 
+/**
+ * Let concurrent identical GET requests share one handler invocation.
+ *
+ * While a GET on the resource is waiting for a separate response, further
+ * GET requests with the same interface and query string are attached to
+ * that separate response instead of invoking the GET handler again. All of
+ * them receive the single result once oc_send_separate_response() (or
+ * oc_request_complete()) is called.
+ *
+ * Only GET handlers that defer their response benefit from coalescing;
+ * requests answered inline and observe registrations are never coalesced.
+ *
+ * @param[in] resource the resource to enable or disable coalescing on
+ * @param[in] state true to coalesce identical GET requests
+ *
+ * @see oc_indicate_separate_response
+ * @see oc_request_defer
+ */
+void oc_resource_set_request_coalescing(oc_resource_t *resource, bool state);
+
+/**
+ * Cache the encoded responses to GET requests on a resource.
+ *
+ * A successful GET without an observe option is stored, keyed by interface,
+ * query string and OCF version of the request. Identical GETs are answered
+ * from the cache for up to `ttl_seconds` without invoking the GET handler.
+ * Access control is still checked for every request. Responses larger than
+ * OC_MAX_CACHED_RESPONSE_SIZE bytes, including the query, are not cached.
+ *
+ * The cache is dropped after every successful PUT, POST or DELETE on the
+ * resource and on oc_notify_observers(). A resource whose state changes by
+ * other means must call oc_resource_invalidate_response_cache(). Only use
+ * the cache for resources whose response does not depend on the client.
+ *
+ * @param[in] resource the resource to cache responses of
+ * @param[in] ttl_seconds how long a response stays valid; 0 disables the
+ *                        cache
+ *
+ * @see oc_resource_invalidate_response_cache
+ */
+void oc_resource_set_response_cache(oc_resource_t *resource,
+                                    uint16_t ttl_seconds);
+
+/**
+ * Drop all responses cached for a resource.
+ *
+ * @param[in] resource the resource whose state has changed
+ *
+ * @see oc_resource_set_response_cache
+ */
+void oc_resource_invalidate_response_cache(oc_resource_t *resource);
+
 /**
  * Specify a request_callback for GET, PUT, POST, and DELETE methods
  *
@@ -1020,6 +1097,48 @@ void oc_resource_set_properties_cbs(oc_resource_t *resource,
  */
 bool oc_add_resource(oc_resource_t *resource);
 
+/**
+ * Start adding resources as a single batch.
+ *
+ * Resources passed to oc_add_resource() until oc_resources_commit_batch() is
+ * called are validated individually, as usual, but are not visible to
+ * clients. Adding a resource to an open batch costs the same regardless of
+ * how many resources the device already has, which makes registering
+ * thousands of resources (e.g. from a bridge) linear overall.
+ *
+ * Example:
+ * ```
+ * oc_resources_begin_batch();
+ * for (i = 0; i < num_sensors; i++) {
+ *   oc_resource_t *res = oc_new_resource(NULL, sensors[i].uri, 1, device);
+ *   ...
+ *   oc_add_resource(res);
+ * }
+ * if (!oc_resources_commit_batch()) {
+ *   ...
+ * }
+ * ```
+ *
+ * @see oc_resources_commit_batch
+ */
+void oc_resources_begin_batch(void);
+
+/**
+ * Publish every resource added since oc_resources_begin_batch().
+ *
+ * URIs are checked for uniqueness per device, against each other and the
+ * resources already added, in a single pass. The batch is all or nothing.
+ *
+ * @return
+ *  - true: all resources of the batch were added to the stack.
+ *  - false: a URI is duplicated or memory ran out; no resource of the batch
+ *    was added. The resources stay allocated and may be deleted with
+ *    oc_delete_resource().
+ *
+ * @see oc_resources_begin_batch
+ */
+bool oc_resources_commit_batch(void);
+
 /**
  * Remove a resource from the IoTivity stack and delete the resource.
  *
@@ -1073,11 +1192,132 @@ typedef void (*oc_con_write_cb_t)(size_t device_index, oc_rep_t *rep);
 */
 void oc_set_con_write_cb(oc_con_write_cb_t callback);
 
+/**
+  @brief Spread responses to multicast discovery requests over time.
+
+  When many devices hear the same multicast discovery request, answering it
+  right away makes all of them reply at once and can overflow the receive
+  buffers of the client. With a leisure period set, the response to a
+  multicast \c /oic/res request is sent after a random delay between 0 and
+  \c leisure_ms milliseconds, as described in RFC 7252, section 8.2.
+  Unicast requests are always answered immediately. Builds without
+  OC_DYNAMIC_ALLOCATION only delay responses when the port configuration
+  defines OC_MAX_DISCOVERY_RESPONSES, the number of responses that may be
+  held back at once.
+  @param leisure_ms Upper bound of the delay in milliseconds, or 0 to respond
+   immediately (default). RFC 7252 suggests 5000.
+  @see oc_set_mcast_discovery_rate_limit
+  @see oc_set_mcast_discovery_suppression
+*/
+void oc_set_mcast_discovery_leisure(uint32_t leisure_ms);
+
+/**
+  @brief Limit the number of multicast discovery responses per client.
+
+  Each client, identified by its address, is answered at most
+  \c max_responses times per \c window_seconds. Further multicast discovery
+  requests from it are ignored until the window ends.
+  @param max_responses Responses allowed per window, or 0 for no limit
+   (default).
+  @param window_seconds Length of the rate limiting window in seconds.
+  @see oc_set_mcast_discovery_leisure
+*/
+void oc_set_mcast_discovery_rate_limit(uint16_t max_responses,
+                                       uint16_t window_seconds);
+
+/**
+  @brief Ignore repeated multicast discovery requests.
+
+  A multicast discovery request with the same query as the previous one from
+  the same client is ignored if it arrives within \c window_ms of it.
+  @param window_ms Suppression window in milliseconds, or 0 to answer every
+   request (default).
+  @see oc_set_mcast_discovery_leisure
+*/
+void oc_set_mcast_discovery_suppression(uint32_t window_ms);
+
 void oc_init_query_iterator(void);
 int oc_iterate_query(oc_request_t *request, char **key, size_t *key_len,
                      char **value, size_t *value_len);
 bool oc_iterate_query_get_values(oc_request_t *request, const char *key,
                                  char **value, int *value_len);
+
+/**
+  @brief Position within the query string of a request.
+
+  Unlike oc_init_query_iterator() and oc_iterate_query(), which share a single
+  position across the whole stack, a query iterator lives on the stack of its
+  caller, so nested or concurrent iterations do not disturb each other.
+  @see oc_query_iterator_init
+*/
+typedef struct oc_query_iterator_s
+{
+  const char *query;
+  size_t query_len;
+  size_t pos;
+} oc_query_iterator_t;
+
+/**
+  @brief Start iterating over the query string of a request.
+  @param iterator Iterator to initialize
+  @param request Request whose query is iterated; its query must outlive the
+   iterator
+*/
+void oc_query_iterator_init(oc_query_iterator_t *iterator,
+                            const oc_request_t *request);
+
+/**
+  @brief Advance to the next key=value pair of the query.
+  @param iterator Iterator initialized by oc_query_iterator_init()
+  @param key Set to the key of the pair (not NUL terminated)
+  @param key_len Set to the length of the key
+  @param value Set to the value of the pair (not NUL terminated)
+  @param value_len Set to the length of the value
+  @return Offset just past the pair in the query, or -1 once no pair is left
+*/
+int oc_query_iterator_next(oc_query_iterator_t *iterator, char **key,
+                           size_t *key_len, char **value, size_t *value_len);
+
+/**
+  @brief Advance to the next value of a key.
+
+  Behaves like oc_iterate_query_get_values() on a caller owned iterator.
+  @param iterator Iterator initialized by oc_query_iterator_init()
+  @param key Key to look for
+  @param value Set to the next value of the key (not NUL terminated)
+  @param value_len Set to the length of the value, or -1 if the key was not
+   found again
+  @return true if the query has more pairs to look at
+*/
+bool oc_query_iterator_get_values(oc_query_iterator_t *iterator,
+                                  const char *key, char **value,
+                                  int *value_len);
+
+/**
+  @brief Callback receiving a value found by oc_iterate_query_get_all_values().
+  @param key_index Index of the matched key in the keys array
+  @param value Value of the pair (not NUL terminated)
+  @param value_len Length of the value
+  @param data User data passed to oc_iterate_query_get_all_values()
+*/
+typedef void (*oc_query_value_cb_t)(size_t key_index, const char *value,
+                                    size_t value_len, void *data);
+
+/**
+  @brief Extract the values of several keys in a single pass over the query.
+
+  Every pair whose key matches one of \c keys is reported to \c cb, in the
+  order the pairs appear in the query.
+  @param request Request whose query is scanned
+  @param keys Keys to look for
+  @param num_keys Number of entries in \c keys
+  @param cb Callback invoked for every matching pair
+  @param data User data passed to \c cb
+  @return Number of matching pairs
+*/
+int oc_iterate_query_get_all_values(const oc_request_t *request,
+                                    const char *const *keys, size_t num_keys,
+                                    oc_query_value_cb_t cb, void *data);
 int oc_get_query_value(oc_request_t *request, const char *key, char **value);
 
 void oc_send_response(oc_request_t *request, oc_status_t response_code);
@@ -1089,6 +1329,45 @@ void oc_set_separate_response_buffer(oc_separate_response_t *handle);
 void oc_send_separate_response(oc_separate_response_t *handle,
                                oc_status_t response_code);
 
+typedef struct oc_deferred_request_s oc_deferred_request_t;
+
+/**
+  @brief Take over a request whose response will be produced later, possibly
+  on another thread.
+
+  Call from the request handler instead of oc_send_response(). The request
+  is answered as a separate response once oc_request_complete() is called
+  on the returned handle. Unlike oc_send_separate_response(), completion
+  does not touch the stack and may happen from any thread.
+
+  @param request the request being handled
+
+  @return the handle to complete, or NULL if no more requests can be
+   deferred (the handler should then respond directly)
+
+  @see oc_request_complete
+*/
+oc_deferred_request_t *oc_request_defer(oc_request_t *request);
+
+/**
+  @brief Complete a deferred request. Safe to call from any thread.
+
+  The payload is copied and handed to the stack through a lock-free queue;
+  the response is sent from the event loop, which is signalled. The handle
+  is released by the stack and must not be used afterwards. Every deferred
+  request must be completed exactly once, before oc_main_shutdown().
+
+  @param handle the handle returned by oc_request_defer()
+  @param code the response code
+  @param payload encoded CBOR representation to send (for example a root
+   object encoded with tinycbor), or NULL
+  @param len length of payload, at most OC_MAX_APP_DATA_SIZE
+
+  @return 0 on success, -1 if the arguments are invalid
+*/
+int oc_request_complete(oc_deferred_request_t *handle, oc_status_t code,
+                        const uint8_t *payload, size_t len);
+
 int oc_notify_observers(oc_resource_t *resource);
 
 #ifdef __cplusplus
@@ -1143,6 +1422,43 @@ bool oc_do_ip_discovery_all_at_endpoint(oc_discovery_all_handler_t handler,
                                         oc_endpoint_t *endpoint,
                                         void *user_data);
 
+/**
+  @brief  Discover all resources and report only what changed since the last
+          discovery cycle.
+
+  Discovered resources are kept in a client-side cache keyed by device UUID.
+  A reply identical to the one last seen from that device is recognized by
+  its payload hash and dropped without being parsed. Otherwise only resources
+  that were added, changed (types, interfaces, policy or endpoints) or removed
+  are passed to the handler, along with the kind of change.
+
+  Each cache entry lives for the TTL set by oc_set_discovery_cache_ttl(),
+  refreshed whenever the device replies. When a new cycle starts, the
+  resources of devices whose entry has expired are reported as removed.
+
+  @param  handler    The callback for resource changes. Must not be NULL.
+  @param  user_data  Callback parameter for user defined value.
+  @return Returns true if it successfully makes and dispatches a coap packet.
+
+  @note A device reachable over both IPv4 and IPv6 is tracked once per address
+        family, because its advertised endpoints are filtered by the family
+        of the reply.
+*/
+bool oc_do_ip_discovery_changes(oc_discovery_changes_handler_t handler,
+                                void *user_data);
+
+/**
+  @brief  Set the lifetime of the discovery cache entries used by
+          oc_do_ip_discovery_changes().
+
+  Choose a TTL larger than the interval between discovery cycles, or devices
+  would be reported as removed and then added again on each cycle.
+
+  @param  ttl_seconds  Seconds a device stays cached after its last reply.
+                       0 disables expiry. The default is 300.
+*/
+void oc_set_discovery_cache_ttl(uint32_t ttl_seconds);
+
 bool oc_do_get(const char *uri, oc_endpoint_t *endpoint, const char *query,
                oc_response_handler_t handler, oc_qos_t qos, void *user_data);
 
@@ -47,6 +47,7 @@ typedef struct oc_blockwise_state_s
   uint8_t ref_count;
 #ifdef OC_DYNAMIC_ALLOCATION
   uint8_t *buffer;
+  bool external_buffer;
 #else  /* OC_DYNAMIC_ALLOCATION */
   uint8_t buffer[OC_MAX_APP_DATA_SIZE];
 #endif /* !OC_DYNAMIC_ALLOCATION */
@@ -100,6 +101,12 @@ oc_blockwise_state_t *oc_blockwise_find_response_buffer(
   oc_method_t method, const char *query, size_t query_len,
   oc_blockwise_role_t role);
 
+oc_blockwise_state_t *oc_blockwise_find_request_buffer_by_endpoint(
+  oc_endpoint_t *endpoint, oc_blockwise_role_t role);
+
+oc_blockwise_state_t *oc_blockwise_find_response_buffer_by_endpoint(
+  oc_endpoint_t *endpoint, oc_blockwise_role_t role);
+
 oc_blockwise_state_t *oc_blockwise_alloc_request_buffer(
   const char *href, size_t href_len, oc_endpoint_t *endpoint,
   oc_method_t method, oc_blockwise_role_t role);
@@ -117,6 +124,21 @@ const void *oc_blockwise_dispatch_block(oc_blockwise_state_t *buffer,
                                         uint32_t requested_block_size,
                                         uint32_t *payload_size);
 
+#ifdef OC_DYNAMIC_ALLOCATION
+/**
+  @brief Serve a response from a payload that is owned by the caller.
+
+  The response state releases its own buffer and dispatches blocks directly
+  from payload, which must stay valid until the state is freed or
+  oc_blockwise_release_external_payload() is called for it.
+*/
+void oc_blockwise_set_external_payload(oc_blockwise_state_t *buffer,
+                                       const uint8_t *payload,
+                                       uint32_t payload_size);
+
+void oc_blockwise_release_external_payload(const uint8_t *payload);
+#endif /* OC_DYNAMIC_ALLOCATION */
+
 bool oc_blockwise_handle_block(oc_blockwise_state_t *buffer,
                                uint32_t incoming_block_offset,
                                const uint8_t *incoming_block,
@@ -124,6 +146,13 @@ bool oc_blockwise_handle_block(oc_blockwise_state_t *buffer,
 
 void oc_blockwise_scrub_buffers(bool all);
 
+/**
+  @brief Free the oldest block-wise transfer, response buffers first.
+
+  @return true if a buffer was freed
+*/
+bool oc_blockwise_evict_oldest(void);
+
 void oc_blockwise_scrub_buffers_for_client_cb(void *cb);
 
 #ifdef __cplusplus
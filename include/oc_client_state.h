@@ -57,6 +57,16 @@ typedef oc_discovery_flags_t (*oc_discovery_handler_t)(
   const char *, const char *, oc_string_array_t, oc_interface_mask_t,
   oc_endpoint_t *, oc_resource_properties_t, void *);
 
+typedef enum {
+  OC_DISCOVERY_RESOURCE_ADDED = 0,
+  OC_DISCOVERY_RESOURCE_CHANGED,
+  OC_DISCOVERY_RESOURCE_REMOVED
+} oc_discovery_change_t;
+
+typedef oc_discovery_flags_t (*oc_discovery_changes_handler_t)(
+  const char *, const char *, oc_string_array_t, oc_interface_mask_t,
+  oc_endpoint_t *, oc_resource_properties_t, oc_discovery_change_t, void *);
+
 typedef void (*oc_response_handler_t)(oc_client_response_t *);
 
 typedef struct oc_client_handler_t
@@ -64,6 +74,7 @@ typedef struct oc_client_handler_t
   oc_response_handler_t response;
   oc_discovery_handler_t discovery;
   oc_discovery_all_handler_t discovery_all;
+  oc_discovery_changes_handler_t discovery_changes;
 } oc_client_handler_t;
 
 typedef struct oc_client_cb_t
@@ -117,6 +128,9 @@ oc_discovery_flags_t oc_ri_process_discovery_payload(
   uint8_t *payload, int len, oc_client_handler_t handler,
   oc_endpoint_t *endpoint, void *user_data);
 
+void oc_ri_expire_discovery_cache(oc_discovery_changes_handler_t handler,
+                                  void *user_data);
+
 #ifdef __cplusplus
 }
 #endif
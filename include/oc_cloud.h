@@ -42,7 +42,8 @@ typedef enum {
   OC_CLOUD_REFRESHED_TOKEN = 8,
   OC_CLOUD_LOGGED_OUT = 16,
   OC_CLOUD_FAILURE = 32,
-  OC_CLOUD_DEREGISTERED = 64
+  OC_CLOUD_DEREGISTERED = 64,
+  OC_CLOUD_TIMING_UPDATED = 128
 } oc_cloud_status_t;
 
 typedef enum oc_cps_t {
@@ -72,6 +73,24 @@ typedef enum {
   CLOUD_ERROR_REFRESH_ACCESS_TOKEN = 3,
 } oc_cloud_error_t;
 
+/**
+  @brief Connection timing of a device, refreshed by the cloud manager.
+
+  The status callback is invoked with OC_CLOUD_TIMING_UPDATED whenever the
+  smoothed round-trip time moves by more than a quarter from the value last
+  reported.
+*/
+typedef struct oc_cloud_timing_t
+{
+  uint32_t rtt_ms;  /**< Round-trip time of the last keepalive ping. */
+  uint32_t srtt_ms; /**< Smoothed keepalive round-trip time. */
+  uint32_t keepalive_ms; /**< Delay until the next keepalive ping. */
+  uint32_t token_refresh_s; /**< Delay at which the access token refresh was
+                               scheduled, 0 if none. */
+  uint32_t reconnect_delay_ms; /**< Backoff applied to the last (re)connect. */
+  uint16_t reconnects; /**< Connection attempts since the last sign-in. */
+} oc_cloud_timing_t;
+
 struct oc_cloud_context_t;
 
 /**
@@ -96,6 +115,7 @@ typedef struct oc_cloud_context_t
   oc_endpoint_t *cloud_ep;
   uint8_t retry_count;
   uint8_t retry_refresh_token_count;
+  uint8_t fast_reconnect_count;
   oc_cloud_error_t last_error;
   uint16_t expires_in;
 
@@ -103,6 +123,12 @@ typedef struct oc_cloud_context_t
   oc_link_t *rd_published_resources;
   oc_link_t *rd_delete_resources;
   bool rd_delete_all;
+  bool rd_flush_scheduled;
+  bool rd_flush_pipelined;
+
+  oc_cloud_timing_t timing;
+  oc_clock_time_t ping_sent;
+  uint32_t reported_srtt_ms;
 
   oc_cps_t cps;
 
@@ -41,6 +41,9 @@ struct oc_link_s
   int64_t ins;
   oc_string_array_t rel;
   OC_LIST_STRUCT(params);
+  oc_collection_t *collection;
+  struct oc_link_s *next_by_resource;
+  struct oc_link_s *next_by_href;
 };
 
 typedef struct oc_rt_t
@@ -70,6 +73,7 @@ struct oc_collection_s
   OC_LIST_STRUCT(mandatory_rts);
   OC_LIST_STRUCT(supported_rts);
   OC_LIST_STRUCT(links);
+  uint16_t batch_timeout_seconds;
 };
 
 bool oc_handle_collection_request(oc_method_t method, oc_request_t *request,
@@ -88,6 +92,10 @@ oc_link_t *oc_get_link_by_uri(oc_collection_t *collection, const char *uri_path,
 
 bool oc_check_if_collection(oc_resource_t *resource);
 void oc_collection_add(oc_collection_t *collection);
+
+bool oc_collection_batch_set_buffer(oc_separate_response_t *handle);
+int oc_collection_batch_send(oc_separate_response_t *handle);
+void oc_collection_free_batch_responses(void);
 #ifdef OC_COLLECTIONS_IF_CREATE
 void oc_collections_free_rt_factories(void);
 #endif /* OC_COLLECTIONS_IF_CREATE */
@@ -70,6 +70,12 @@ oc_device_info_t *oc_core_get_device_info(size_t device);
 
 oc_platform_info_t *oc_core_get_platform_info(void);
 
+/* Drop the encoded oic.wk.d / oic.wk.p properties cached for responses. Must
+ * be called after changing the device or platform info in place.
+ */
+void oc_core_invalidate_device_reps(size_t device);
+void oc_core_invalidate_platform_reps(void);
+
 void oc_core_encode_interfaces_mask(CborEncoder *parent,
                                     oc_interface_mask_t iface_mask);
 
@@ -28,6 +28,12 @@ extern "C"
 
 void oc_create_discovery_resource(int resource_idx, size_t device);
 
+void oc_discovery_free_delayed_responses(void);
+
+#ifdef OC_CLIENT
+void oc_discovery_cache_free(void);
+#endif /* OC_CLIENT */
+
 #ifdef __cplusplus
 }
 #endif
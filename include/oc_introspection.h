@@ -18,9 +18,13 @@
  * @brief functions for introspection
  *
  * The IDD information is served up as encoded CBOR content (read as is).
- * If the size of the IDD data is to big for the buffer, then an internal error
- * is returned.  Note that some build options can only serve up introspection
- * data for one device and can not be used if multiple devices are implemented.
+ * With OC_IDD_API on builds with dynamic allocation and block-wise transfers,
+ * the IDD of each device is loaded once and served in place through
+ * block-wise transfers, with an ETag derived from its content, so it may
+ * exceed the application data buffer. Otherwise, if the size of the IDD data
+ * is to big for the buffer, then an internal error is returned.  Note that
+ * some build options can only serve up introspection data for one device and
+ * can not be used if multiple devices are implemented.
  *
  * There are multiple mechanisms for adding introspection data to a server.
  *
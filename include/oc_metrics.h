@@ -0,0 +1,134 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+/**
+  @file
+
+  Runtime metrics: counters for the events that usually explain a stack
+  running out of resources (dropped messages, exhausted pools, CoAP
+  retransmissions, handshake failures) and fixed-bucket latency histograms
+  of the time spent in resource entity handlers.
+
+  All counters compile down to nothing unless the stack is built with
+  OC_METRICS.
+*/
+#ifndef OC_METRICS_H
+#define OC_METRICS_H
+
+#include "oc_ri.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  OC_METRICS_MESSAGES_RECEIVED = 0,
+  OC_METRICS_MESSAGES_SENT,
+  OC_METRICS_MESSAGES_DROPPED_IN,
+  OC_METRICS_MESSAGES_DROPPED_OUT,
+  OC_METRICS_TRANSACTIONS_EXHAUSTED,
+  OC_METRICS_RETRANSMISSIONS,
+  OC_METRICS_TRANSACTION_TIMEOUTS,
+  OC_METRICS_BLOCKWISE_TIMEOUTS,
+  OC_METRICS_OBSERVERS,
+  OC_METRICS_HANDSHAKE_FAILURES,
+  OC_METRICS_REQUESTS,
+  OC_METRICS_REQUESTS_REJECTED,
+  OC_METRICS_NUM_COUNTERS
+} oc_metrics_counter_t;
+
+/** Upper bounds (in microseconds) of the latency histogram buckets; the
+ * last bucket counts everything above the final bound. */
+#define OC_METRICS_LATENCY_BOUNDS_US                                           \
+  {                                                                            \
+    100, 500, 1000, 5000, 10000, 50000, 100000                                 \
+  }
+#define OC_METRICS_LATENCY_BUCKETS (8)
+
+typedef struct
+{
+  uint32_t buckets[OC_METRICS_LATENCY_BUCKETS];
+  uint32_t count;
+  uint64_t total_us;
+  uint32_t max_us;
+} oc_metrics_histogram_t;
+
+typedef struct
+{
+  uint32_t counters[OC_METRICS_NUM_COUNTERS];
+  oc_metrics_histogram_t handler_latency;
+} oc_metrics_t;
+
+#ifdef OC_METRICS
+void oc_metrics_add(oc_metrics_counter_t id, int32_t delta);
+void oc_metrics_record_latency(oc_resource_t *resource, uint32_t elapsed_us);
+void oc_metrics_free_resource(oc_resource_t *resource);
+
+#define OC_METRICS_INC(id) oc_metrics_add((id), 1)
+#define OC_METRICS_DEC(id) oc_metrics_add((id), -1)
+#else /* OC_METRICS */
+#define OC_METRICS_INC(id)
+#define OC_METRICS_DEC(id)
+#endif /* !OC_METRICS */
+
+/**
+  @brief Copy a consistent view of all stack-wide counters and the
+  aggregate entity handler latency histogram.
+
+  @param out destination of the snapshot (cannot be NULL)
+*/
+void oc_metrics_snapshot(oc_metrics_t *out);
+
+/**
+  @brief Copy the entity handler latency histogram of one resource.
+
+  @param resource the resource whose latency was recorded
+  @param out destination of the histogram (cannot be NULL)
+
+  @return 0 on success, -1 if no request was ever served by the resource
+*/
+int oc_metrics_resource_latency(oc_resource_t *resource,
+                                oc_metrics_histogram_t *out);
+
+/**
+  @brief Return the name of a counter, as used by the diagnostics resource.
+*/
+const char *oc_metrics_counter_name(oc_metrics_counter_t id);
+
+/** Zero all counters (except gauges) and histograms. */
+void oc_metrics_reset(void);
+
+#ifdef OC_SERVER
+/**
+  @brief Add the secured diagnostics resource (/oc/metrics, rt
+  "x.org.iotivity.metrics") to a device. It is served through the regular
+  request path and is listed in discovery. A POST resets the counters.
+
+  @param device index of the logical device
+
+  @return the new resource, or NULL on failure
+*/
+oc_resource_t *oc_metrics_add_diagnostics_resource(size_t device);
+#endif /* OC_SERVER */
+
+/** Release per-resource histograms; called on stack shutdown. */
+void oc_metrics_free(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OC_METRICS_H */
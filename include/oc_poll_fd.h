@@ -0,0 +1,102 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+/**
+  @file
+
+  Event loop integration through a single pollable file descriptor.
+
+  Instead of running oc_main_poll() in a dedicated thread that sleeps on a
+  condition variable, an application with its own event loop (epoll, libuv,
+  asio, ...) adds the descriptor returned by oc_poll_fd_open() to that loop
+  and calls oc_poll_fd_dispatch() whenever it becomes readable. The
+  descriptor becomes readable when the stack has pending events or when the
+  next timer is due.
+
+  Available on Linux only.
+
+  Example:
+  ```
+  static const oc_handler_t handler = {
+    .init = app_init,
+    .signal_event_loop = oc_poll_fd_signal,
+    .register_resources = register_resources
+  };
+
+  int fd = oc_poll_fd_open();
+  if (fd < 0 || oc_main_init(&handler) < 0)
+    return -1;
+
+  struct epoll_event ev = { .events = EPOLLIN, .data.fd = fd };
+  epoll_ctl(app_epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+  ...
+  // in the application's loop, when fd is readable:
+  oc_poll_fd_dispatch();
+  ...
+  oc_main_shutdown();
+  oc_poll_fd_close();
+  ```
+*/
+#ifndef OC_POLL_FD_H
+#define OC_POLL_FD_H
+
+#include "port/oc_clock.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Create the pollable descriptor.
+ *
+ * Must be called before oc_main_init(). The descriptor is initially readable
+ * so that the first oc_poll_fd_dispatch() runs the events queued during
+ * initialization. Calling it again returns the same descriptor.
+ *
+ * @return the descriptor, to be polled for readability, or -1 on error
+ */
+int oc_poll_fd_open(void);
+
+/**
+ * Mark the descriptor readable.
+ *
+ * Pass this function as the signal_event_loop handler in oc_handler_t. It
+ * may be called from any thread.
+ */
+void oc_poll_fd_signal(void);
+
+/**
+ * Run the stack after the descriptor became readable.
+ *
+ * Clears the descriptor, calls oc_main_poll() and arms the descriptor to
+ * become readable again when the next timer expires. Must be called from the
+ * thread that runs the application's event loop.
+ *
+ * @return the absolute time of the next timer in oc_clock_time() ticks, or 0
+ * if no timer is pending (same as oc_main_poll())
+ */
+oc_clock_time_t oc_poll_fd_dispatch(void);
+
+/**
+ * Close the descriptor. Call after oc_main_shutdown().
+ */
+void oc_poll_fd_close(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OC_POLL_FD_H */
@@ -71,6 +71,37 @@ int oc_rep_get_encoded_payload_size(void);
  */
 const uint8_t *oc_rep_get_encoder_buf(void);
 
+/**
+ * Get the current write position of an encoder.
+ *
+ * Together with oc_rep_encode_raw this allows a sequence of already encoded
+ * cbor items to be captured and replayed later. It is unlikely to be used
+ * outside the IoTivity-lite library.
+ *
+ * @param[in] encoder the encoder of the container being encoded (for example
+ *                    `&root_map`)
+ *
+ * @return
+ *  - pointer to the next byte the encoder will write
+ *  - NULL if an encoding error occurred or the payload buffer is exhausted
+ */
+const uint8_t *oc_rep_get_encoder_pos(const CborEncoder *encoder);
+
+/**
+ * Append already encoded cbor items to an indefinite length container.
+ *
+ * The data must be a sequence of complete cbor items that was encoded into a
+ * container of the same kind, for instance key/value pairs for a map. An out
+ * of memory error is recorded if the data does not fit the payload buffer.
+ *
+ * @param[in] encoder the encoder of the container being encoded
+ * @param[in] data    the encoded cbor items
+ * @param[in] len     the length of data in bytes
+ *
+ * @see oc_rep_get_encoder_pos
+ */
+void oc_rep_encode_raw(CborEncoder *encoder, const uint8_t *data, size_t len);
+
 /**
  * Get a pointer to the cbor object with the given `name`
  *
@@ -176,6 +176,8 @@ struct oc_resource_s
   uint8_t num_links;
 #endif /* OC_COLLECTIONS */
   uint16_t observe_period_seconds;
+  bool coalesce_requests;
+  uint16_t response_cache_ttl;
 };
 
 typedef struct oc_link_s oc_link_t;
@@ -226,6 +228,13 @@ oc_resource_t *oc_ri_get_app_resources(void);
 oc_resource_t *oc_ri_alloc_resource(void);
 bool oc_ri_add_resource(oc_resource_t *resource);
 bool oc_ri_delete_resource(oc_resource_t *resource);
+
+void oc_ri_begin_resource_batch(void);
+bool oc_ri_commit_resource_batch(void);
+
+void oc_ri_release_coalesced_gets(oc_separate_response_t *handle);
+
+void oc_ri_invalidate_cached_responses(oc_resource_t *resource);
 #endif /* OC_SERVER */
 
 void oc_ri_free_resource_properties(oc_resource_t *resource);
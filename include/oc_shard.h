@@ -0,0 +1,163 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+/**
+  @file
+
+  Sharded runtime for hosting many logical devices on several cores.
+
+  The stack keeps one scheduler, timer list, transaction and observer table
+  per process. oc_shard_run() therefore shards by process: it forks one
+  worker per shard, and each worker initializes its own stack instance with
+  its own subset of logical devices and its own storage directory. The
+  workers run independently on separate cores and exchange application
+  messages through per-shard mailboxes.
+
+  A typical worker:
+  ```
+  static int shard_main(int shard, void *data)
+  {
+    oc_storage_config(shard_storage_dir[shard]);
+    int fd = oc_poll_fd_open();
+    if (fd < 0 || oc_main_init(&handler) < 0)
+      return -1;
+    struct pollfd fds[2] = { { fd, POLLIN, 0 },
+                             { oc_shard_inbox_fd(), POLLIN, 0 } };
+    while (!quit) {
+      poll(fds, 2, -1);
+      if (fds[0].revents & POLLIN)
+        oc_poll_fd_dispatch();
+      if (fds[1].revents & POLLIN)
+        oc_shard_receive(handle_message, NULL);
+    }
+    oc_main_shutdown();
+    oc_poll_fd_close();
+    return 0;
+  }
+
+  int main(void)
+  {
+    return oc_shard_run(4, shard_main, NULL);
+  }
+  ```
+
+  Available on Linux only.
+*/
+#ifndef OC_SHARD_H
+#define OC_SHARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Maximum number of shards
+ */
+#ifndef OC_MAX_NUM_SHARDS
+#define OC_MAX_NUM_SHARDS (64)
+#endif /* !OC_MAX_NUM_SHARDS */
+
+/**
+ * Maximum size of a message passed between shards
+ */
+#ifndef OC_SHARD_MAX_MESSAGE_SIZE
+#define OC_SHARD_MAX_MESSAGE_SIZE (4096)
+#endif /* !OC_SHARD_MAX_MESSAGE_SIZE */
+
+/**
+ * Entry point of a shard worker.
+ *
+ * @param shard index of the shard, from 0 to num_shards - 1
+ * @param data the data passed to oc_shard_run()
+ *
+ * @return 0 on success, the worker exits with a failure status otherwise
+ */
+typedef int (*oc_shard_main_cb_t)(int shard, void *data);
+
+/**
+ * Callback invoked for each message received by oc_shard_receive().
+ *
+ * @param from index of the sending shard, or -1 for the parent process
+ * @param message the message; only valid during the callback
+ * @param length length of the message
+ * @param user_data the data passed to oc_shard_receive()
+ */
+typedef void (*oc_shard_message_cb_t)(int from, const uint8_t *message,
+                                      size_t length, void *user_data);
+
+/**
+ * Run num_shards workers, each in its own process, and wait for all of them
+ * to exit.
+ *
+ * Must be called before oc_main_init(); each worker initializes its own
+ * stack from shard_main. SIGINT and SIGTERM received by the calling process
+ * are forwarded to the workers.
+ *
+ * @param num_shards number of workers, at most OC_MAX_NUM_SHARDS
+ * @param shard_main worker entry point
+ * @param data passed to shard_main
+ *
+ * @return the number of workers that failed, or -1 if the workers could not
+ * be started
+ */
+int oc_shard_run(int num_shards, oc_shard_main_cb_t shard_main, void *data);
+
+/**
+ * @return the index of the calling shard, or -1 outside of a worker
+ */
+int oc_shard_id(void);
+
+/**
+ * @return the number of shards started by oc_shard_run(), or 0
+ */
+int oc_shard_count(void);
+
+/**
+ * Send a message to another shard. Does not block; the message is dropped
+ * if the destination mailbox is full.
+ *
+ * @param shard index of the destination shard
+ * @param message the message to copy
+ * @param length length of the message, at most OC_SHARD_MAX_MESSAGE_SIZE
+ *
+ * @return 0 on success, -1 on error
+ */
+int oc_shard_send(int shard, const void *message, size_t length);
+
+/**
+ * @return a descriptor that is readable while messages are waiting in the
+ * calling shard's mailbox, or -1 outside of a worker
+ */
+int oc_shard_inbox_fd(void);
+
+/**
+ * Deliver all waiting messages of the calling shard's mailbox.
+ *
+ * @param cb invoked for each message
+ * @param user_data passed to cb
+ *
+ * @return the number of messages delivered
+ */
+int oc_shard_receive(oc_shard_message_cb_t cb, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OC_SHARD_H */
@@ -0,0 +1,116 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+/**
+  @file
+
+  Per-message trace points along the request pipeline, from the socket
+  receive to the socket send. Each event carries a monotonic timestamp and
+  the CoAP message ID and token so that the stages of one exchange can be
+  lined up. Events are kept in a fixed-size lock-free ring buffer that can
+  be dumped as a Chrome trace (chrome://tracing, Perfetto) or as plain text
+  lines that sort and diff well next to perf output.
+
+  The trace points compile to nothing unless the stack is built with
+  OC_TRACE.
+*/
+#ifndef OC_TRACE_H
+#define OC_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  OC_TRACE_RECV_MSG = 0,
+  OC_TRACE_NETWORK_EVENT,
+  OC_TRACE_RECV_MESSAGE,
+  OC_TRACE_TLS_DECRYPT,
+  OC_TRACE_COAP_RECEIVE,
+  OC_TRACE_HANDLER_BEGIN,
+  OC_TRACE_HANDLER_END,
+  OC_TRACE_COAP_SERIALIZE,
+  OC_TRACE_SEND_MSG,
+  OC_TRACE_NUM_STAGES
+} oc_trace_stage_t;
+
+typedef struct
+{
+  uint64_t timestamp_ns;
+  uint16_t mid;
+  uint8_t stage;
+  uint8_t token_len;
+  uint8_t token[8];
+} oc_trace_event_t;
+
+#ifdef OC_TRACE
+struct oc_message_s;
+
+void oc_trace_event(oc_trace_stage_t stage, uint16_t mid, const uint8_t *token,
+                    size_t token_len);
+void oc_trace_message(oc_trace_stage_t stage,
+                      const struct oc_message_s *message);
+
+#define OC_TRACE_EVENT(stage, mid, token, token_len)                           \
+  oc_trace_event((stage), (mid), (token), (token_len))
+#define OC_TRACE_MESSAGE(stage, message) oc_trace_message((stage), (message))
+#else /* OC_TRACE */
+#define OC_TRACE_EVENT(stage, mid, token, token_len)
+#define OC_TRACE_MESSAGE(stage, message)
+#endif /* !OC_TRACE */
+
+/**
+  @brief Copy the events currently held in the ring buffer, oldest first.
+  Events overwritten while being copied are skipped.
+
+  @param events destination array
+  @param max_events capacity of the destination array
+
+  @return number of events copied
+*/
+size_t oc_trace_read(oc_trace_event_t *events, size_t max_events);
+
+/** Discard all recorded events. */
+void oc_trace_clear(void);
+
+/** Return the name of a pipeline stage. */
+const char *oc_trace_stage_name(oc_trace_stage_t stage);
+
+/**
+  @brief Write the recorded events as a Chrome trace JSON document. Handler
+  begin/end events are emitted as duration events, all other stages as
+  instant events.
+
+  @return 0 on success, -1 on a write error
+*/
+int oc_trace_dump_chrome(FILE *out);
+
+/**
+  @brief Write the recorded events one per line as
+  "<seconds>.<nanoseconds> <stage> mid=<mid> token=<hex>".
+
+  @return 0 on success, -1 on a write error
+*/
+int oc_trace_dump_text(FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OC_TRACE_H */
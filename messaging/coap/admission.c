@@ -0,0 +1,303 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#ifdef OC_ADMISSION_CONTROL
+#include "admission.h"
+#include "coap.h"
+#ifdef OC_BLOCK_WISE
+#include "oc_blockwise.h"
+#endif /* OC_BLOCK_WISE */
+#include "oc_metrics.h"
+#include "port/oc_clock.h"
+#include "port/oc_log.h"
+#include "transactions.h"
+#include "util/oc_process.h"
+#include <string.h>
+
+/* Per-source token bucket. Credit is kept in clock ticks: one request costs
+ * OC_CLOCK_SECOND and every elapsed tick earns OC_ADMISSION_RATE.
+ */
+typedef struct
+{
+  oc_endpoint_t source;
+  oc_clock_time_t credit;
+  oc_clock_time_t last_seen;
+  bool in_use;
+} admission_source_t;
+
+#define REQUEST_COST ((oc_clock_time_t)OC_CLOCK_SECOND)
+#define MAX_CREDIT ((oc_clock_time_t)OC_ADMISSION_BURST * REQUEST_COST)
+
+static admission_source_t sources[OC_ADMISSION_MAX_SOURCES];
+
+typedef struct
+{
+  coap_message_type_t type;
+  uint8_t code;
+  uint16_t mid;
+  uint8_t token_len;
+  const uint8_t *token;
+  size_t options;
+} request_header_t;
+
+static bool
+peek_header(oc_message_t *msg, request_header_t *h)
+{
+  const uint8_t *data = msg->data;
+  size_t offset;
+
+  if (msg->length == 0) {
+    return false;
+  }
+
+#ifdef OC_TCP
+  if (msg->endpoint.flags & TCP) {
+    /* Len(4) TKL(4) [extended length] Code Token */
+    uint8_t len = data[0] >> 4;
+    offset = 1 + (len < 13 ? 0 : (size_t)1 << (len - 13));
+    h->type = COAP_TYPE_NON;
+    h->mid = 0;
+  } else
+#endif /* OC_TCP */
+  {
+    /* Ver(2) T(2) TKL(4) Code MID(16) Token */
+    if (msg->length < COAP_HEADER_LEN) {
+      return false;
+    }
+    offset = 1;
+    h->type = (coap_message_type_t)((data[0] & COAP_HEADER_TYPE_MASK) >>
+                                    COAP_HEADER_TYPE_POSITION);
+    h->mid = (uint16_t)(data[2] << 8 | data[3]);
+  }
+  h->token_len = data[0] & COAP_HEADER_TOKEN_LEN_MASK;
+  if (offset >= msg->length || h->token_len > COAP_TOKEN_LEN) {
+    return false;
+  }
+  h->code = data[offset];
+  offset += (msg->endpoint.flags & TCP) ? 1 : 3;
+  if (offset + h->token_len > msg->length) {
+    return false;
+  }
+  h->token = data + offset;
+  h->options = offset + h->token_len;
+  return true;
+}
+
+#ifdef OC_BLOCK_WISE
+/* Returns true if the request carries a Block1 or Block2 option with a
+ * block number above 0, i.e. it continues a transfer rather than starting
+ * one.
+ */
+static bool
+is_block_continuation(oc_message_t *msg, request_header_t *h)
+{
+  const uint8_t *data = msg->data;
+  size_t offset = h->options;
+  unsigned int number = 0;
+
+  while (offset < msg->length && data[offset] != 0xFF) {
+    unsigned int delta = data[offset] >> 4;
+    size_t len = data[offset] & 0x0F;
+    offset++;
+    if (delta == 13 && offset < msg->length) {
+      delta = 13 + data[offset++];
+    } else if (delta == 14 && offset + 1 < msg->length) {
+      delta = 269 + (unsigned int)(data[offset] << 8 | data[offset + 1]);
+      offset += 2;
+    } else if (delta >= 13) {
+      return false;
+    }
+    if (len == 13 && offset < msg->length) {
+      len = 13 + data[offset++];
+    } else if (len == 14 && offset + 1 < msg->length) {
+      len = 269 + (size_t)(data[offset] << 8 | data[offset + 1]);
+      offset += 2;
+    } else if (len >= 13) {
+      return false;
+    }
+    if (offset + len > msg->length) {
+      return false;
+    }
+    number += delta;
+    if (number > COAP_OPTION_BLOCK1) {
+      return false;
+    }
+    if ((number == COAP_OPTION_BLOCK1 || number == COAP_OPTION_BLOCK2) &&
+        len > 0 && len <= 3) {
+      uint32_t value = 0;
+      size_t i;
+      for (i = 0; i < len; i++) {
+        value = value << 8 | data[offset + i];
+      }
+      if ((value >> 4) > 0) {
+        return true;
+      }
+    }
+    offset += len;
+  }
+  return false;
+}
+
+/* Later blocks of a transfer the server already admitted are not charged
+ * again, so a large payload costs its source a single token.
+ */
+static bool
+continues_admitted_transfer(oc_message_t *msg, request_header_t *h)
+{
+  if (!is_block_continuation(msg, h)) {
+    return false;
+  }
+  return oc_blockwise_find_request_buffer_by_endpoint(
+           &msg->endpoint, OC_BLOCKWISE_SERVER) != NULL ||
+         oc_blockwise_find_response_buffer_by_endpoint(
+           &msg->endpoint, OC_BLOCKWISE_SERVER) != NULL;
+}
+#endif /* OC_BLOCK_WISE */
+
+static admission_source_t *
+lookup_source(oc_endpoint_t *endpoint, oc_clock_time_t now)
+{
+  admission_source_t *oldest = &sources[0];
+  int i;
+
+  for (i = 0; i < OC_ADMISSION_MAX_SOURCES; i++) {
+    if (!sources[i].in_use) {
+      oldest = &sources[i];
+      break;
+    }
+    if (oc_endpoint_compare_address(&sources[i].source, endpoint) == 0) {
+      return &sources[i];
+    }
+    if (sources[i].last_seen < oldest->last_seen) {
+      oldest = &sources[i];
+    }
+  }
+
+  memcpy(&oldest->source, endpoint, sizeof(oc_endpoint_t));
+  oldest->credit = MAX_CREDIT;
+  oldest->last_seen = now;
+  oldest->in_use = true;
+  return oldest;
+}
+
+/* Returns 0 if the request may proceed, or the number of seconds after which
+ * the source will have credit for another request.
+ */
+static uint32_t
+take_token(oc_endpoint_t *endpoint)
+{
+  oc_clock_time_t now = oc_clock_time();
+  admission_source_t *s = lookup_source(endpoint, now);
+  oc_clock_time_t elapsed = (now > s->last_seen) ? now - s->last_seen : 0;
+
+  s->last_seen = now;
+  if (elapsed >= MAX_CREDIT / OC_ADMISSION_RATE) {
+    s->credit = MAX_CREDIT;
+  } else {
+    s->credit += elapsed * OC_ADMISSION_RATE;
+    if (s->credit > MAX_CREDIT) {
+      s->credit = MAX_CREDIT;
+    }
+  }
+
+  if (s->credit >= REQUEST_COST) {
+    s->credit -= REQUEST_COST;
+    return 0;
+  }
+
+  oc_clock_time_t wait = (REQUEST_COST - s->credit) / OC_ADMISSION_RATE;
+  uint32_t seconds = (uint32_t)((wait + OC_CLOCK_SECOND - 1) / OC_CLOCK_SECOND);
+  return (seconds > 0) ? seconds : 1;
+}
+
+static void
+send_service_unavailable(oc_message_t *msg, request_header_t *h,
+                         uint32_t max_age)
+{
+  coap_packet_t response[1];
+  oc_message_t *message;
+
+#ifdef OC_TCP
+  if (msg->endpoint.flags & TCP) {
+    coap_tcp_init_message(response, SERVICE_UNAVAILABLE_5_03);
+  } else
+#endif /* OC_TCP */
+  {
+    coap_udp_init_message(
+      response, (h->type == COAP_TYPE_CON) ? COAP_TYPE_ACK : COAP_TYPE_NON,
+      SERVICE_UNAVAILABLE_5_03,
+      (h->type == COAP_TYPE_CON) ? h->mid : coap_get_mid());
+  }
+  coap_set_token(response, h->token, h->token_len);
+  coap_set_header_max_age(response, max_age);
+
+  message = oc_internal_allocate_outgoing_message();
+  if (!message) {
+    return;
+  }
+  memcpy(&message->endpoint, &msg->endpoint, sizeof(oc_endpoint_t));
+  message->length = coap_serialize_message(response, message->data);
+  if (message->length > 0) {
+    coap_send_message(message);
+  }
+  if (message->ref_count == 0) {
+    oc_message_unref(message);
+  }
+}
+
+bool
+coap_admit_message(oc_message_t *msg)
+{
+  request_header_t h;
+  uint32_t max_age = 0;
+
+  if (!peek_header(msg, &h) || h.code < COAP_GET || h.code > COAP_DELETE) {
+    return true;
+  }
+#ifdef OC_BLOCK_WISE
+  if (continues_admitted_transfer(msg, &h)) {
+    return true;
+  }
+#endif /* OC_BLOCK_WISE */
+
+  if (coap_get_num_transactions() >= OC_ADMISSION_MAX_IN_FLIGHT ||
+      oc_process_nevents() >= OC_ADMISSION_MAX_QUEUED) {
+    OC_WRN("admission: stack overloaded, rejecting request");
+    max_age = OC_ADMISSION_RETRY_AFTER;
+  } else {
+    max_age = take_token(&msg->endpoint);
+    if (max_age == 0) {
+      return true;
+    }
+    OC_WRN("admission: request rate exceeded by source");
+    OC_LOGipaddr(msg->endpoint);
+  }
+
+  OC_METRICS_INC(OC_METRICS_REQUESTS_REJECTED);
+  if (!(msg->endpoint.flags & MULTICAST)) {
+    send_service_unavailable(msg, &h, max_age);
+  }
+  return false;
+}
+
+void
+coap_admission_reset(void)
+{
+  memset(sources, 0, sizeof(sources));
+}
+#else  /* OC_ADMISSION_CONTROL */
+typedef int dummy_declaration;
+#endif /* !OC_ADMISSION_CONTROL */
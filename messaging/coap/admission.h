@@ -0,0 +1,83 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include "oc_buffer.h"
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Sustained requests per second admitted from one source address. */
+#ifndef OC_ADMISSION_RATE
+#define OC_ADMISSION_RATE (20)
+#endif /* !OC_ADMISSION_RATE */
+
+/* Requests a source may send in a burst above the sustained rate. */
+#ifndef OC_ADMISSION_BURST
+#define OC_ADMISSION_BURST (40)
+#endif /* !OC_ADMISSION_BURST */
+
+/* Number of source addresses tracked; the least recently seen source is
+ * forgotten when a new one arrives. */
+#ifndef OC_ADMISSION_MAX_SOURCES
+#define OC_ADMISSION_MAX_SOURCES (32)
+#endif /* !OC_ADMISSION_MAX_SOURCES */
+
+/* Open CoAP transactions at which new requests are rejected. Static builds
+ * reject once the transaction pool is exhausted. */
+#ifndef OC_ADMISSION_MAX_IN_FLIGHT
+#ifdef OC_DYNAMIC_ALLOCATION
+#define OC_ADMISSION_MAX_IN_FLIGHT (32)
+#else /* OC_DYNAMIC_ALLOCATION */
+#define OC_ADMISSION_MAX_IN_FLIGHT (COAP_MAX_OPEN_TRANSACTIONS)
+#endif /* !OC_DYNAMIC_ALLOCATION */
+#endif /* !OC_ADMISSION_MAX_IN_FLIGHT */
+
+/* Pending events at which new requests are rejected. Static builds allow a
+ * few queued events per concurrent request on top of housekeeping. */
+#ifndef OC_ADMISSION_MAX_QUEUED
+#ifdef OC_DYNAMIC_ALLOCATION
+#define OC_ADMISSION_MAX_QUEUED (64)
+#else /* OC_DYNAMIC_ALLOCATION */
+#define OC_ADMISSION_MAX_QUEUED (4 * OC_MAX_NUM_CONCURRENT_REQUESTS + 8)
+#endif /* !OC_DYNAMIC_ALLOCATION */
+#endif /* !OC_ADMISSION_MAX_QUEUED */
+
+/* Max-Age, in seconds, sent with 5.03 when the stack is overloaded. */
+#ifndef OC_ADMISSION_RETRY_AFTER
+#define OC_ADMISSION_RETRY_AFTER (2)
+#endif /* !OC_ADMISSION_RETRY_AFTER */
+
+/* Decides from the CoAP header alone whether an incoming request is
+ * processed. Rejected requests are answered with 5.03 Service Unavailable
+ * and a Max-Age hint (multicast requests are dropped silently) and false is
+ * returned. Responses, ACKs and signaling messages are always admitted, and
+ * so are the later blocks of a block-wise transfer already in progress.
+ */
+bool coap_admit_message(oc_message_t *msg);
+
+void coap_admission_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ADMISSION_H */
@@ -50,6 +50,7 @@
 
 #include "coap.h"
 #include "transactions.h"
+#include "oc_trace.h"
 
 #ifdef OC_TCP
 #include "coap_signal.h"
@@ -1095,6 +1096,8 @@ coap_serialize_message(void *packet, uint8_t *buffer)
   OC_DBG("Dump");
   OC_LOGbytes(coap_pkt->buffer, (coap_pkt->payload_len + option - buffer));
 
+  OC_TRACE_EVENT(OC_TRACE_COAP_SERIALIZE, coap_pkt->mid, coap_pkt->token,
+                 coap_pkt->token_len);
   return (option - buffer) + coap_pkt->payload_len; /* packet length */
 
 exit:
@@ -53,6 +53,7 @@
 #include "api/oc_events.h"
 #include "oc_api.h"
 #include "oc_buffer.h"
+#include "oc_trace.h"
 
 #ifdef OC_SECURITY
 #include "security/oc_tls.h"
@@ -70,6 +71,10 @@
 #include "coap_signal.h"
 #endif
 
+#ifdef OC_ADMISSION_CONTROL
+#include "admission.h"
+#endif /* OC_ADMISSION_CONTROL */
+
 OC_PROCESS(coap_engine, "CoAP Engine");
 
 #ifdef OC_BLOCK_WISE
@@ -138,6 +143,13 @@ coap_receive(oc_message_t *msg)
   OC_LOGipaddr(msg->endpoint);
   OC_LOGbytes(msg->data, msg->length);
 
+#ifdef OC_ADMISSION_CONTROL
+  if (!coap_admit_message(msg)) {
+    coap_status_code = SERVICE_UNAVAILABLE_5_03;
+    return coap_status_code;
+  }
+#endif /* OC_ADMISSION_CONTROL */
+
   /* static declaration reduces stack peaks and program code size */
   static coap_packet_t
     message[1]; /* this way the packet can be treated as pointer as usual */
@@ -172,6 +184,8 @@ coap_receive(oc_message_t *msg)
   }
 
   if (coap_status_code == COAP_NO_ERROR) {
+    OC_TRACE_EVENT(OC_TRACE_COAP_RECEIVE, message->mid, message->token,
+                   message->token_len);
 
 #ifdef OC_DEBUG
     OC_DBG("  Parsed: CoAP version: %u, token: 0x%02X%02X, mid: %u",
@@ -520,7 +534,11 @@ coap_receive(oc_message_t *msg)
             if (payload) {
               coap_set_payload(response, payload, payload_size);
             }
-            if (block2 || response_buffer->payload_size > block2_size) {
+            /* A 2.03 Valid response validates the whole representation
+             * and carries neither a payload nor a Block2 option.
+             */
+            if (response->code != VALID_2_03 &&
+                (block2 || response_buffer->payload_size > block2_size)) {
               coap_set_header_block2(
                 response, 0,
                 (response_buffer->payload_size > block2_size) ? 1 : 0,
@@ -847,6 +865,9 @@ OC_PROCESS_THREAD(coap_engine, ev, data)
 
   coap_register_as_transaction_handler();
   coap_init_connection();
+#ifdef OC_ADMISSION_CONTROL
+  coap_admission_reset();
+#endif /* OC_ADMISSION_CONTROL */
 
   while (1) {
     OC_PROCESS_YIELD();
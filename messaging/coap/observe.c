@@ -50,11 +50,13 @@
 #ifdef OC_SERVER
 
 #include "observe.h"
+#include "util/oc_mem_budget.h"
 #include "util/oc_memb.h"
 #include <stdio.h>
 #include <string.h>
 
 #include "oc_buffer.h"
+#include "oc_metrics.h"
 #ifdef OC_SECURITY
 #include "security/oc_acl_internal.h"
 #include "security/oc_pstat.h"
@@ -97,6 +99,8 @@ coap_remove_observer_handle_by_uri(oc_endpoint_t *endpoint, const char *uri,
       obs->resource->num_observers--;
       oc_list_remove(observers_list, obs);
       oc_memb_free(&observers_memb, obs);
+      OC_MEM_RELEASE(OC_MEM_OBSERVERS, sizeof(coap_observer_t));
+      OC_METRICS_DEC(OC_METRICS_OBSERVERS);
       removed++;
       break;
     }
@@ -120,7 +124,13 @@ add_observer(oc_resource_t *resource, oc_endpoint_t *endpoint,
   int dup =
     coap_remove_observer_handle_by_uri(endpoint, uri, (int)uri_len, iface_mask);
 
-  coap_observer_t *o = oc_memb_alloc(&observers_memb);
+  coap_observer_t *o = NULL;
+  if (OC_MEM_CHARGE(OC_MEM_OBSERVERS, sizeof(coap_observer_t))) {
+    o = oc_memb_alloc(&observers_memb);
+    if (!o) {
+      OC_MEM_RELEASE(OC_MEM_OBSERVERS, sizeof(coap_observer_t));
+    }
+  }
 
   if (o) {
     oc_new_string(&o->url, uri, uri_len);
@@ -145,6 +155,7 @@ add_observer(oc_resource_t *resource, oc_endpoint_t *endpoint,
            oc_string(o->url), o->token[0], o->token[1]);
 #endif /* !OC_DYNAMIC_ALLOCATION */
     oc_list_add(observers_list, o);
+    OC_METRICS_INC(OC_METRICS_OBSERVERS);
     return dup;
   }
   OC_WRN("insufficient memory to add new observer");
@@ -199,6 +210,8 @@ coap_remove_observer(coap_observer_t *o)
   oc_free_string(&o->url);
   oc_list_remove(observers_list, o);
   oc_memb_free(&observers_memb, o);
+  OC_MEM_RELEASE(OC_MEM_OBSERVERS, sizeof(coap_observer_t));
+  OC_METRICS_DEC(OC_METRICS_OBSERVERS);
 }
 void
 coap_free_all_observers(void)
@@ -563,13 +576,17 @@ coap_notify_collections(oc_resource_t *resource)
   oc_collection_t *collection = NULL;
 
   for (collection = oc_get_next_collection_with_link(resource, NULL);
-       collection != NULL && collection->num_observers > 0;
+       collection != NULL;
        collection = oc_get_next_collection_with_link(resource, collection)) {
+    if (collection->num_observers == 0) {
+      continue;
+    }
     OC_DBG("coap_notify_collections: Issue GET request to collection for "
            "resource");
 
     request.resource = (oc_resource_t *)collection;
 
+    oc_rep_new(response_buffer.buffer, response_buffer.buffer_size);
     oc_handle_collection_request(OC_GET, &request, OC_IF_B, resource);
 
     coap_notify_collection_observers(request.resource, &response_buffer,
@@ -42,6 +42,12 @@ struct oc_response_buffer_s
   uint16_t buffer_size;
   uint16_t response_length;
   int code;
+#if defined(OC_BLOCK_WISE) && defined(OC_DYNAMIC_ALLOCATION)
+  /* Payload served in place of buffer, without copying, if set */
+  const uint8_t *payload;
+  uint32_t payload_size;
+  const uint8_t *etag;
+#endif /* OC_BLOCK_WISE && OC_DYNAMIC_ALLOCATION */
 };
 
 #ifdef __cplusplus
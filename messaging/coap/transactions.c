@@ -49,6 +49,7 @@
 #include "api/oc_main.h"
 #include "observe.h"
 #include "oc_buffer.h"
+#include "oc_metrics.h"
 #include "util/oc_list.h"
 #include "util/oc_memb.h"
 #include <string.h>
@@ -103,6 +104,7 @@ coap_new_transaction(uint16_t mid, oc_endpoint_t *endpoint)
     }
   } else {
     OC_WRN("insufficient memory to create transaction");
+    OC_METRICS_INC(OC_METRICS_TRANSACTIONS_EXHAUSTED);
   }
 
   return t;
@@ -144,6 +146,7 @@ coap_send_transaction(coap_transaction_t *t)
       } else {
         t->retrans_timer.timer.interval <<= 1; /* double */
         OC_DBG("Doubled %d", (int)t->retrans_timer.timer.interval);
+        OC_METRICS_INC(OC_METRICS_RETRANSMISSIONS);
       }
 
       OC_PROCESS_CONTEXT_BEGIN(transaction_handler_process);
@@ -158,6 +161,7 @@ coap_send_transaction(coap_transaction_t *t)
     } else {
       /* timed out */
       OC_WRN("Timeout");
+      OC_METRICS_INC(OC_METRICS_TRANSACTION_TIMEOUTS);
 #ifdef OC_SERVER
       /* remove observers */
       coap_remove_observer_by_client(&t->message->endpoint);
@@ -237,6 +241,12 @@ coap_check_transactions(void)
   }
 }
 /*---------------------------------------------------------------------------*/
+int
+coap_get_num_transactions(void)
+{
+  return oc_list_length(transactions_list);
+}
+/*---------------------------------------------------------------------------*/
 void
 coap_free_all_transactions(void)
 {
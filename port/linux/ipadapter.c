@@ -23,6 +23,7 @@
 #include "oc_core_res.h"
 #include "oc_endpoint.h"
 #include "oc_network_monitor.h"
+#include "oc_trace.h"
 #include "port/oc_assert.h"
 #include "port/oc_connectivity.h"
 #include <arpa/inet.h>
@@ -926,6 +927,7 @@ network_event_thread(void *data)
       PRINT("\n\n");
 #endif /* OC_DEBUG */
 
+      OC_TRACE_MESSAGE(OC_TRACE_RECV_MSG, message);
       oc_network_event(message);
     }
   }
@@ -1021,6 +1023,7 @@ send_msg(int sock, struct sockaddr_storage *receiver, oc_message_t *message)
 int
 oc_send_buffer(oc_message_t *message)
 {
+  OC_TRACE_MESSAGE(OC_TRACE_SEND_MSG, message);
 #ifdef OC_DEBUG
   PRINT("Outgoing message of size %zd bytes to ", message->length);
   PRINTipaddr(message->endpoint);
@@ -0,0 +1,134 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "oc_poll_fd.h"
+#include "oc_api.h"
+#include "port/oc_log.h"
+#include <stdint.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+/* The descriptor handed to the application is an epoll instance holding an
+ * eventfd, written by oc_poll_fd_signal(), and a timerfd armed for the next
+ * etimer expiry. The timerfd uses CLOCK_REALTIME like oc_clock_time() so
+ * the absolute time returned by oc_main_poll() can be used directly.
+ */
+static int poll_fd = -1;
+static int event_fd = -1;
+static int timer_fd = -1;
+
+static void
+close_fds(void)
+{
+  if (timer_fd >= 0) {
+    close(timer_fd);
+    timer_fd = -1;
+  }
+  if (event_fd >= 0) {
+    close(event_fd);
+    event_fd = -1;
+  }
+  if (poll_fd >= 0) {
+    close(poll_fd);
+    poll_fd = -1;
+  }
+}
+
+static int
+add_fd(int fd)
+{
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = EPOLLIN;
+  ev.data.fd = fd;
+  return epoll_ctl(poll_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+int
+oc_poll_fd_open(void)
+{
+  if (poll_fd >= 0) {
+    return poll_fd;
+  }
+
+  poll_fd = epoll_create1(EPOLL_CLOEXEC);
+  event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  timer_fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (poll_fd < 0 || event_fd < 0 || timer_fd < 0 || add_fd(event_fd) < 0 ||
+      add_fd(timer_fd) < 0) {
+    OC_ERR("could not create the poll descriptor");
+    close_fds();
+    return -1;
+  }
+
+  oc_poll_fd_signal();
+  return poll_fd;
+}
+
+void
+oc_poll_fd_signal(void)
+{
+  uint64_t one = 1;
+  if (event_fd >= 0) {
+    ssize_t ret = write(event_fd, &one, sizeof(one));
+    (void)ret;
+  }
+}
+
+oc_clock_time_t
+oc_poll_fd_dispatch(void)
+{
+  uint64_t count;
+  struct itimerspec its;
+  ssize_t ret;
+
+  if (poll_fd < 0) {
+    return 0;
+  }
+
+  /* Clear both descriptors before running the stack, so that a signal
+   * raised while oc_main_poll() runs leaves the descriptor readable.
+   */
+  ret = read(event_fd, &count, sizeof(count));
+  ret = read(timer_fd, &count, sizeof(count));
+  (void)ret;
+
+  oc_clock_time_t next_event = oc_main_poll();
+
+  memset(&its, 0, sizeof(its));
+  if (next_event != 0) {
+    its.it_value.tv_sec = (time_t)(next_event / OC_CLOCK_SECOND);
+    its.it_value.tv_nsec =
+      (long)((next_event % OC_CLOCK_SECOND) * 1.e09 / OC_CLOCK_SECOND);
+    if (its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0) {
+      /* A zero value would disarm the timer. */
+      its.it_value.tv_nsec = 1;
+    }
+  }
+  if (timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, NULL) < 0) {
+    OC_WRN("could not arm the poll descriptor timer");
+  }
+  return next_event;
+}
+
+void
+oc_poll_fd_close(void)
+{
+  close_fds();
+}
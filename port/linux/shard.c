@@ -0,0 +1,241 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "oc_shard.h"
+#include "port/oc_log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* Every mailbox is a datagram socket pair. The worker that owns a mailbox
+ * keeps its receiving end; every process keeps all sending ends so that any
+ * shard, and the parent, can post to any other shard.
+ */
+typedef struct
+{
+  int32_t from;
+} shard_header_t;
+
+static int num_shards;
+static int current_shard = -1;
+static int inbox[OC_MAX_NUM_SHARDS];
+static int outbox[OC_MAX_NUM_SHARDS];
+static pid_t workers[OC_MAX_NUM_SHARDS];
+
+static void
+close_mailboxes(int count)
+{
+  int i;
+  for (i = 0; i < count; i++) {
+    if (inbox[i] >= 0) {
+      close(inbox[i]);
+      inbox[i] = -1;
+    }
+    if (outbox[i] >= 0) {
+      close(outbox[i]);
+      outbox[i] = -1;
+    }
+  }
+}
+
+static void
+forward_signal(int signal)
+{
+  int i;
+  for (i = 0; i < num_shards; i++) {
+    if (workers[i] > 0) {
+      kill(workers[i], signal);
+    }
+  }
+}
+
+static int
+wait_workers(int started)
+{
+  int i, status, failed = 0;
+  for (i = 0; i < started; i++) {
+    while (waitpid(workers[i], &status, 0) < 0) {
+      if (errno != EINTR) {
+        status = -1;
+        break;
+      }
+    }
+    if (status != 0) {
+      OC_WRN("shard %d exited with status %d", i, status);
+      failed++;
+    }
+    workers[i] = 0;
+  }
+  return failed;
+}
+
+int
+oc_shard_run(int num, oc_shard_main_cb_t shard_main, void *data)
+{
+  struct sigaction sa, old_int, old_term;
+  int i, sv[2], failed;
+
+  if (num <= 0 || num > OC_MAX_NUM_SHARDS || !shard_main ||
+      current_shard >= 0 || num_shards > 0) {
+    return -1;
+  }
+
+  for (i = 0; i < num; i++) {
+    inbox[i] = outbox[i] = -1;
+  }
+  for (i = 0; i < num; i++) {
+    if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, sv) < 0) {
+      OC_ERR("could not create the mailbox of shard %d", i);
+      close_mailboxes(i);
+      return -1;
+    }
+    fcntl(sv[0], F_SETFL, fcntl(sv[0], F_GETFL) | O_NONBLOCK);
+    inbox[i] = sv[0];
+    outbox[i] = sv[1];
+  }
+
+  num_shards = num;
+  memset(&sa, 0, sizeof(sa));
+  sigfillset(&sa.sa_mask);
+  sa.sa_handler = forward_signal;
+  sigaction(SIGINT, &sa, &old_int);
+  sigaction(SIGTERM, &sa, &old_term);
+
+  for (i = 0; i < num; i++) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      int j, ret;
+      sigaction(SIGINT, &old_int, NULL);
+      sigaction(SIGTERM, &old_term, NULL);
+      current_shard = i;
+      for (j = 0; j < num; j++) {
+        if (j != i) {
+          close(inbox[j]);
+          inbox[j] = -1;
+        }
+      }
+      ret = shard_main(i, data);
+      exit(ret == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    if (pid < 0) {
+      OC_ERR("could not start shard %d", i);
+      num_shards = i;
+      forward_signal(SIGTERM);
+      wait_workers(i);
+      break;
+    }
+    workers[i] = pid;
+  }
+
+  /* The parent only sends. */
+  for (i = 0; i < num; i++) {
+    close(inbox[i]);
+    inbox[i] = -1;
+  }
+
+  failed = (num_shards == num) ? wait_workers(num) : -1;
+
+  sigaction(SIGINT, &old_int, NULL);
+  sigaction(SIGTERM, &old_term, NULL);
+  close_mailboxes(num);
+  num_shards = 0;
+  return failed;
+}
+
+int
+oc_shard_id(void)
+{
+  return current_shard;
+}
+
+int
+oc_shard_count(void)
+{
+  return num_shards;
+}
+
+int
+oc_shard_send(int shard, const void *message, size_t length)
+{
+  shard_header_t header;
+  struct iovec iov[2];
+  struct msghdr msg;
+
+  if (shard < 0 || shard >= num_shards || outbox[shard] < 0 ||
+      length > OC_SHARD_MAX_MESSAGE_SIZE) {
+    return -1;
+  }
+
+  header.from = current_shard;
+  iov[0].iov_base = &header;
+  iov[0].iov_len = sizeof(header);
+  iov[1].iov_base = (void *)message;
+  iov[1].iov_len = length;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = 2;
+
+  if (sendmsg(outbox[shard], &msg, MSG_DONTWAIT) < 0) {
+    OC_WRN("could not send to shard %d: %d", shard, errno);
+    return -1;
+  }
+  return 0;
+}
+
+int
+oc_shard_inbox_fd(void)
+{
+  return (current_shard >= 0) ? inbox[current_shard] : -1;
+}
+
+int
+oc_shard_receive(oc_shard_message_cb_t cb, void *user_data)
+{
+  static uint8_t buffer[sizeof(shard_header_t) + OC_SHARD_MAX_MESSAGE_SIZE];
+  shard_header_t header;
+  int count = 0;
+
+  if (current_shard < 0) {
+    return 0;
+  }
+
+  for (;;) {
+    ssize_t len = recv(inbox[current_shard], buffer, sizeof(buffer), 0);
+    if (len < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    if ((size_t)len < sizeof(header)) {
+      continue;
+    }
+    memcpy(&header, buffer, sizeof(header));
+    if (cb) {
+      cb(header.from, buffer + sizeof(header), (size_t)len - sizeof(header),
+         user_data);
+    }
+    count++;
+  }
+  return count;
+}
@@ -92,6 +92,7 @@ oc_sec_doxm_default(size_t device)
   oc_device_info_t *d = oc_core_get_device_info(device);
   oc_gen_uuid(&doxm[device].deviceuuid);
   memcpy(d->di.id, doxm[device].deviceuuid.id, 16);
+  oc_core_invalidate_device_reps(device);
   oc_sec_dump_doxm(device);
 }
 
@@ -281,6 +282,7 @@ oc_sec_decode_doxm(oc_rep_t *rep, bool from_storage, size_t device)
         oc_str_to_uuid(oc_string(rep->value.string), &doxm[device].deviceuuid);
         oc_uuid_t *deviceuuid = oc_core_get_device_id(device);
         memcpy(deviceuuid->id, doxm[device].deviceuuid.id, 16);
+        oc_core_invalidate_device_reps(device);
       } else if (len == 12 &&
                  memcmp(oc_string(rep->name), "devowneruuid", 12) == 0) {
         oc_str_to_uuid(oc_string(rep->value.string),
@@ -153,6 +153,7 @@ oc_pstat_handle_state(oc_sec_pstat_t *ps, size_t device, bool from_storage,
     if (!from_storage && oc_get_con_res_announced()) {
       oc_device_info_t *di = oc_core_get_device_info(device);
       oc_free_string(&di->name);
+      oc_core_invalidate_device_reps(device);
     }
 #ifdef OC_PKI
     oc_sec_free_roles_for_device(device);
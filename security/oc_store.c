@@ -84,6 +84,7 @@ oc_sec_load_doxm(size_t device)
   oc_uuid_t *deviceuuid = oc_core_get_device_id(device);
   oc_sec_doxm_t *doxm = oc_sec_get_doxm(device);
   memcpy(deviceuuid, &doxm->deviceuuid, sizeof(oc_uuid_t));
+  oc_core_invalidate_device_reps(device);
 }
 
 void
@@ -522,6 +523,8 @@ oc_sec_load_unique_ids(size_t device)
       }
     }
     oc_free_rep(p);
+    oc_core_invalidate_platform_reps();
+    oc_core_invalidate_device_reps(device);
   } else {
     oc_sec_dump_unique_ids(device);
   }
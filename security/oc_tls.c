@@ -48,10 +48,13 @@
 #include "oc_cred_internal.h"
 #include "oc_doxm.h"
 #include "oc_endpoint.h"
+#include "oc_metrics.h"
+#include "oc_trace.h"
 #include "oc_pstat.h"
 #include "oc_roles.h"
 #include "oc_svr.h"
 #include "oc_tls.h"
+#include "util/oc_mem_budget.h"
 
 OC_PROCESS(oc_tls_handler, "TLS Process");
 OC_MEMB(tls_peers_s, oc_tls_peer_t, OC_MAX_TLS_PEERS);
@@ -234,6 +237,84 @@ is_peer_active(oc_tls_peer_t *peer)
   return false;
 }
 
+#if defined(OC_CLOUD) && defined(OC_CLIENT) && defined(OC_TCP)
+#ifndef OC_TLS_SAVED_SESSIONS
+#define OC_TLS_SAVED_SESSIONS (2)
+#endif /* !OC_TLS_SAVED_SESSIONS */
+
+/* Sessions last negotiated with TLS-over-TCP servers (i.e. the cloud). They
+ * are offered again when reconnecting to the same server so that it can
+ * resume the session with an abbreviated handshake.
+ */
+typedef struct
+{
+  oc_endpoint_t endpoint;
+  mbedtls_ssl_session session;
+  bool valid;
+} oc_tls_saved_session_t;
+
+static oc_tls_saved_session_t saved_sessions[OC_TLS_SAVED_SESSIONS];
+static size_t next_saved_session;
+
+static oc_tls_saved_session_t *
+get_saved_session(oc_endpoint_t *endpoint)
+{
+  size_t i;
+  for (i = 0; i < OC_TLS_SAVED_SESSIONS; i++) {
+    if (saved_sessions[i].valid &&
+        oc_endpoint_compare(&saved_sessions[i].endpoint, endpoint) == 0) {
+      return &saved_sessions[i];
+    }
+  }
+  return NULL;
+}
+
+static void
+free_saved_session(oc_tls_saved_session_t *saved)
+{
+  if (saved->valid) {
+    mbedtls_ssl_session_free(&saved->session);
+    saved->valid = false;
+  }
+}
+
+static void
+oc_tls_free_saved_sessions(void)
+{
+  size_t i;
+  for (i = 0; i < OC_TLS_SAVED_SESSIONS; i++) {
+    free_saved_session(&saved_sessions[i]);
+  }
+}
+
+static void
+oc_tls_save_session(oc_tls_peer_t *peer)
+{
+  oc_tls_saved_session_t *saved = get_saved_session(&peer->endpoint);
+  if (!saved) {
+    saved = &saved_sessions[next_saved_session];
+    next_saved_session = (next_saved_session + 1) % OC_TLS_SAVED_SESSIONS;
+  }
+  free_saved_session(saved);
+  mbedtls_ssl_session_init(&saved->session);
+  if (mbedtls_ssl_get_session(&peer->ssl_ctx, &saved->session) != 0) {
+    mbedtls_ssl_session_free(&saved->session);
+    return;
+  }
+  memcpy(&saved->endpoint, &peer->endpoint, sizeof(oc_endpoint_t));
+  saved->valid = true;
+}
+
+static void
+oc_tls_resume_session(oc_tls_peer_t *peer)
+{
+  oc_tls_saved_session_t *saved = get_saved_session(&peer->endpoint);
+  if (saved && mbedtls_ssl_set_session(&peer->ssl_ctx, &saved->session) == 0) {
+    OC_DBG("oc_tls: offering saved session for resumption");
+  }
+}
+#endif /* OC_CLOUD && OC_CLIENT && OC_TCP */
+
 static oc_event_callback_retval_t oc_tls_inactive(void *data);
 
 static void
@@ -288,6 +369,7 @@ oc_tls_free_peer(oc_tls_peer_t *peer, bool inactivity_cb)
   mbedtls_ssl_config_free(&peer->ssl_conf);
   oc_etimer_stop(&peer->timer.fin_timer);
   oc_memb_free(&tls_peers_s, peer);
+  OC_MEM_RELEASE(OC_MEM_TLS_PEERS, sizeof(oc_tls_peer_t));
 }
 
 oc_tls_peer_t *
@@ -455,6 +537,7 @@ check_retr_timers(void)
           mbedtls_strerror(ret, buf, 256);
           OC_ERR("oc_tls: mbedtls_error: %s", buf);
 #endif /* OC_DEBUG */
+          OC_METRICS_INC(OC_METRICS_HANDSHAKE_FAILURES);
           oc_tls_free_peer(peer, false);
         }
       }
@@ -767,6 +850,10 @@ void
 oc_tls_refresh_identity_certs(void)
 {
   OC_DBG("refreshing identity certs");
+#if defined(OC_CLOUD) && defined(OC_CLIENT) && defined(OC_TCP)
+  /* Saved sessions were authenticated with the previous credentials */
+  oc_tls_free_saved_sessions();
+#endif /* OC_CLOUD && OC_CLIENT && OC_TCP */
   oc_tls_refresh_certs(OC_CREDUSAGE_MFG_CERT | OC_CREDUSAGE_IDENTITY_CERT,
                        is_known_identity_cert, add_new_identity_cert);
 }
@@ -890,6 +977,9 @@ void
 oc_tls_refresh_trust_anchors(void)
 {
   OC_DBG("refreshing trust anchors");
+#if defined(OC_CLOUD) && defined(OC_CLIENT) && defined(OC_TCP)
+  oc_tls_free_saved_sessions();
+#endif /* OC_CLOUD && OC_CLIENT && OC_TCP */
   oc_tls_refresh_certs(OC_CREDUSAGE_MFG_TRUSTCA | OC_CREDUSAGE_TRUSTCA,
                        is_known_trust_anchor, add_new_trust_anchor);
 }
@@ -1188,6 +1278,9 @@ oc_tls_add_peer(oc_endpoint_t *endpoint, int role)
 {
   oc_tls_peer_t *peer = oc_tls_get_peer(endpoint);
   if (!peer) {
+    if (!OC_MEM_CHARGE(OC_MEM_TLS_PEERS, sizeof(oc_tls_peer_t))) {
+      return NULL;
+    }
     peer = oc_memb_alloc(&tls_peers_s);
     if (peer) {
       OC_DBG("oc_tls: Allocating new peer");
@@ -1223,16 +1316,24 @@ oc_tls_add_peer(oc_endpoint_t *endpoint, int role)
       if (err != 0) {
         OC_ERR("oc_tls: error in mbedtls_ssl_setup: %d", err);
         oc_memb_free(&tls_peers_s, peer);
+        OC_MEM_RELEASE(OC_MEM_TLS_PEERS, sizeof(oc_tls_peer_t));
         return NULL;
       }
 
       mbedtls_ssl_set_bio(&peer->ssl_ctx, peer, ssl_send, ssl_recv, NULL);
 
+#if defined(OC_CLOUD) && defined(OC_CLIENT) && defined(OC_TCP)
+      if (role == MBEDTLS_SSL_IS_CLIENT && (endpoint->flags & TCP)) {
+        oc_tls_resume_session(peer);
+      }
+#endif /* OC_CLOUD && OC_CLIENT && OC_TCP */
+
       if (role == MBEDTLS_SSL_IS_SERVER &&
           mbedtls_ssl_set_client_transport_id(
             &peer->ssl_ctx, (const unsigned char *)&endpoint->addr,
             sizeof(endpoint->addr)) != 0) {
         oc_memb_free(&tls_peers_s, peer);
+        OC_MEM_RELEASE(OC_MEM_TLS_PEERS, sizeof(oc_tls_peer_t));
         return NULL;
       }
       oc_list_add(tls_peers, peer);
@@ -1244,6 +1345,7 @@ oc_tls_add_peer(oc_endpoint_t *endpoint, int role)
           peer, oc_tls_inactive, (oc_clock_time_t)OC_DTLS_INACTIVITY_TIMEOUT);
       }
     } else {
+      OC_MEM_RELEASE(OC_MEM_TLS_PEERS, sizeof(oc_tls_peer_t));
       OC_WRN("TLS peers exhausted");
     }
   }
@@ -1258,6 +1360,9 @@ oc_tls_shutdown(void)
     oc_tls_free_peer(p, false);
     p = oc_list_pop(tls_peers);
   }
+#if defined(OC_CLOUD) && defined(OC_CLIENT) && defined(OC_TCP)
+  oc_tls_free_saved_sessions();
+#endif /* OC_CLOUD && OC_CLIENT && OC_TCP */
 #ifdef OC_PKI
   oc_x509_crt_t *cert = (oc_x509_crt_t *)oc_list_pop(identity_certs);
   while (cert != NULL) {
@@ -1331,6 +1436,30 @@ oc_tls_close_connection(oc_endpoint_t *endpoint)
   }
 }
 
+bool
+oc_tls_evict_idle_peer(void)
+{
+  oc_tls_peer_t *peer = oc_list_head(tls_peers), *idle = NULL;
+  while (peer != NULL) {
+    /* Peers still in a handshake are not idle, and TLS sessions are torn
+     * down by their own connection. */
+    if ((peer->endpoint.flags & TCP) == 0 &&
+        peer->ssl_ctx.state == MBEDTLS_SSL_HANDSHAKE_OVER &&
+        (!idle || peer->timestamp < idle->timestamp)) {
+      idle = peer;
+    }
+    peer = peer->next;
+  }
+  if (!idle) {
+    return false;
+  }
+  OC_DBG("oc_tls: evicting the least recently active DTLS peer");
+  mbedtls_ssl_close_notify(&idle->ssl_ctx);
+  mbedtls_ssl_close_notify(&idle->ssl_ctx);
+  oc_tls_free_peer(idle, false);
+  return true;
+}
+
 static int
 oc_tls_prf(const uint8_t *secret, size_t secret_len, uint8_t *output,
            size_t output_len, size_t num_message_fragments, ...)
@@ -1579,6 +1708,7 @@ oc_tls_init_connection(oc_message_t *message)
       mbedtls_strerror(ret, buf, 256);
       OC_ERR("oc_tls: mbedtls_error: %s", buf);
 #endif /* OC_DEBUG */
+      OC_METRICS_INC(OC_METRICS_HANDSHAKE_FAILURES);
       oc_tls_free_peer(peer, false);
     } else if (ret == 0) {
       oc_tls_handler_schedule_write(peer);
@@ -1674,6 +1804,7 @@ read_application_data(oc_tls_peer_t *peer)
         mbedtls_strerror(ret, buf, 256);
         OC_ERR("oc_tls: mbedtls_error: %s", buf);
 #endif /* OC_DEBUG */
+        OC_METRICS_INC(OC_METRICS_HANDSHAKE_FAILURES);
         oc_tls_free_peer(peer, false);
         return;
       }
@@ -1684,6 +1815,12 @@ read_application_data(oc_tls_peer_t *peer)
              peer->ssl_ctx.session->ciphersuite);
       oc_handle_session(&peer->endpoint, OC_SESSION_CONNECTED);
 #ifdef OC_CLIENT
+#if defined(OC_CLOUD) && defined(OC_TCP)
+      if (peer->role == MBEDTLS_SSL_IS_CLIENT &&
+          (peer->endpoint.flags & TCP)) {
+        oc_tls_save_session(peer);
+      }
+#endif /* OC_CLOUD && OC_TCP */
 #if defined(OC_CLOUD) && defined(OC_PKI)
       if (!peer->ssl_conf.f_vrfy) {
         const mbedtls_x509_crt *cert =
@@ -1741,6 +1878,7 @@ read_application_data(oc_tls_peer_t *peer)
       }
       message->length = ret;
       message->encrypted = 0;
+      OC_TRACE_MESSAGE(OC_TRACE_TLS_DECRYPT, message);
       oc_recv_message(message);
       OC_DBG("oc_tls: Decrypted incoming message");
     }
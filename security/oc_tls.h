@@ -71,6 +71,8 @@ bool oc_sec_derive_owner_psk(oc_endpoint_t *endpoint, const uint8_t *oxm,
                              uint8_t *key, const size_t key_len);
 
 void oc_tls_remove_peer(oc_endpoint_t *endpoint);
+/* Close the least recently active DTLS session; false if there is none. */
+bool oc_tls_evict_idle_peer(void);
 size_t oc_tls_send_message(oc_message_t *message);
 oc_uuid_t *oc_tls_get_peer_uuid(oc_endpoint_t *endpoint);
 oc_tls_peer_t *oc_tls_get_peer(oc_endpoint_t *endpoint);
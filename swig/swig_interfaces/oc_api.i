@@ -710,6 +710,7 @@ void jni_reset_device(size_t device) {
 %rename(collectionGetCollections) oc_collection_get_collections;
 %rename(collectionAddSupportedResourceType) oc_collection_add_supported_rt;
 %rename(collectionAddMandatoryResourceType) oc_collection_add_mandatory_rt;
+%rename(collectionSetAsyncBatch) oc_collection_set_async_batch;
 // custom instance of oc_resource_make_public to handle OC_SECURITY
 %ignore oc_resource_make_public;
 %rename(resourceMakePublic) jni_resource_make_public;
@@ -724,6 +725,9 @@ void jni_resource_make_public(oc_resource_t *resource) {
 %rename(resourceSetDiscoverable) oc_resource_set_discoverable;
 %rename(resourceSetObservable) oc_resource_set_observable;
 %rename(resourceSetPeriodicObservable) oc_resource_set_periodic_observable;
+%rename(resourceSetRequestCoalescing) oc_resource_set_request_coalescing;
+%rename(resourceSetResponseCache) oc_resource_set_response_cache;
+%rename(resourceInvalidateResponseCache) oc_resource_invalidate_response_cache;
 
 /* Code and typemaps for mapping the oc_resource_set_request_handler to the java OCRequestHandler */
 %{
@@ -925,6 +929,8 @@ void jni_resource_set_properties_cbs(oc_resource_t *resource,
 }
 %}
 %rename(addResource) oc_add_resource;
+%rename(resourcesBeginBatch) oc_resources_begin_batch;
+%rename(resourcesCommitBatch) oc_resources_commit_batch;
 %ignore oc_delete_resource;
 %rename(deleteResource) jni_delete_resource;
 %inline %{
@@ -1034,11 +1040,20 @@ void jni_oc_con_callback(size_t device_index, oc_rep_t *rep)
    */
   public";
 %rename(setConWriteHandler) oc_set_con_write_cb;
+%rename(setMcastDiscoveryLeisure) oc_set_mcast_discovery_leisure;
+%rename(setMcastDiscoveryRateLimit) oc_set_mcast_discovery_rate_limit;
+%rename(setMcastDiscoverySuppression) oc_set_mcast_discovery_suppression;
 
 %ignore oc_init_query_iterator;
 %ignore oc_iterate_query;
 %ignore oc_get_query_value;
 %ignore oc_iterate_query_get_values;
+%ignore oc_query_iterator_t;
+%ignore oc_query_iterator_init;
+%ignore oc_query_iterator_next;
+%ignore oc_query_iterator_get_values;
+%ignore oc_query_value_cb_t;
+%ignore oc_iterate_query_get_all_values;
 
 %typemap(jni)    jobject getQueryValues "jobject";
 %typemap(jtype)  jobject getQueryValues "java.util.List<OCQueryValue>";
@@ -1082,10 +1097,11 @@ SWIGEXPORT jobject JNICALL Java_org_iotivity_OCMainJNI_getQueryValues(JNIEnv *je
   size_t value_len = 0;
   char temp_buffer[512];
   int pos = 0;
+  oc_query_iterator_t iterator;
 
-  oc_init_query_iterator();
+  oc_query_iterator_init(&iterator, request);
   do {
-    pos = oc_iterate_query(request, &current_key, &key_len, &current_value, &value_len);
+    pos = oc_query_iterator_next(&iterator, &current_key, &key_len, &current_value, &value_len);
     // check that a value was found and it will fit in the temp_buffer with room for the '\0' char
     if (pos != -1 && key_len < 512 && value_len < 512) {
       strncpy(temp_buffer, current_key, key_len);
@@ -1117,6 +1133,10 @@ SWIGEXPORT jobject JNICALL Java_org_iotivity_OCMainJNI_getQueryValues(JNIEnv *je
 %rename(indicateSeparateResponse) oc_indicate_separate_response;
 %rename(setSeparateResponseBuffer) oc_set_separate_response_buffer;
 %rename(sendSeparateResponse) oc_send_separate_response;
+// deferred completion takes a raw payload buffer that is not mapped to a java byte[]
+%ignore oc_deferred_request_t;
+%ignore oc_request_defer;
+%ignore oc_request_complete;
 %rename(notifyObservers) oc_notify_observers;
 
 // client side
@@ -1359,6 +1379,10 @@ bool jni_oc_do_ip_discovery_all_at_endpoint(oc_discovery_all_handler_t handler,
 }
 %}
 
+// the changes handler has no Java callback mapping yet
+%ignore oc_do_ip_discovery_changes;
+%rename(setDiscoveryCacheTtl) oc_set_discovery_cache_ttl;
+
 /* Code and typemaps for mapping the oc_do_get, oc_do_delete, oc_init_put, oc_init_post, oc_do_observe,
  * and oc_do_ip_multicast to the java OCResponseHandler */
 %{
@@ -1794,6 +1818,8 @@ void jni_oc_remove_delayed_callback(jobject callback) {
 %ignore oc_response_handler_t;
 %ignore oc_discovery_handler_t;
 %ignore oc_discovery_all_handler_t;
+%ignore oc_discovery_changes_handler_t;
+%rename(OCDiscoveryChange) oc_discovery_change_t;
 %rename (OCClientCallback) oc_client_cb_t;
 %ignore oc_client_cb_t::handler; /*part of the oc_client_cb_t */
 %ignore oc_client_cb_t::user_data;
@@ -1810,5 +1836,6 @@ void jni_oc_remove_delayed_callback(jobject callback) {
 %ignore oc_ri_free_client_cbs_by_endpoint;
 %ignore oc_ri_free_client_cbs_by_mid;
 %ignore oc_ri_process_discovery_payload;
+%ignore oc_ri_expire_discovery_cache;
 %include "oc_client_state.h"
 /*******************End oc_client_state.h*******************/
\ No newline at end of file
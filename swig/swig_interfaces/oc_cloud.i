@@ -102,12 +102,23 @@ static void jni_cloud_cb(oc_cloud_context_t *ctx, oc_cloud_status_t status, void
 %rename (cloudEndpoint) oc_cloud_context_t::cloud_ep;
 %rename (retryCount) oc_cloud_context_t::retry_count;
 %rename (retryRefreshTokenCount) oc_cloud_context_t::retry_refresh_token_count;
+%rename (fastReconnectCount) oc_cloud_context_t::fast_reconnect_count;
 %rename (lastError) oc_cloud_context_t::last_error;
 %rename (expiresIn) oc_cloud_context_t::expires_in;
 %rename (rdPublishResources) oc_cloud_context_t::rd_publish_resources;
 %rename (rdPublishedResources) oc_cloud_context_t::rd_published_resources;
 %rename (rdDeleteResources) oc_cloud_context_t::rd_delete_resources;
 %rename (rdDeleteAll) oc_cloud_context_t::rd_delete_all;
+%rename (rdFlushScheduled) oc_cloud_context_t::rd_flush_scheduled;
+%rename (rdFlushPipelined) oc_cloud_context_t::rd_flush_pipelined;
+%rename (OCCloudTiming) oc_cloud_timing_t;
+%rename (rttMs) oc_cloud_timing_t::rtt_ms;
+%rename (srttMs) oc_cloud_timing_t::srtt_ms;
+%rename (keepaliveMs) oc_cloud_timing_t::keepalive_ms;
+%rename (tokenRefreshS) oc_cloud_timing_t::token_refresh_s;
+%rename (reconnectDelayMs) oc_cloud_timing_t::reconnect_delay_ms;
+%ignore oc_cloud_context_t::ping_sent;
+%ignore oc_cloud_context_t::reported_srtt_ms;
 %ignore oc_cloud_context_t::cps;
 %rename (cloudConf) oc_cloud_context_t::cloud_conf;
 %rename (cloudManager) oc_cloud_context_t::cloud_manager;
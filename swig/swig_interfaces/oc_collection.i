@@ -16,6 +16,9 @@
 typedef struct oc_link_s oc_link_t;
 %rename(OCLink) oc_link_s;
 %ignore oc_link_s::OC_LIST_STRUCT(params);
+%ignore oc_link_s::collection;
+%ignore oc_link_s::next_by_resource;
+%ignore oc_link_s::next_by_href;
 %extend oc_link_s {
   oc_link_params_t *getParamsListHead() {
     return oc_list_head(self->params);
@@ -60,5 +63,7 @@ typedef struct oc_collection_s oc_collection_t;
 %rename(getLinkByUri) oc_get_link_by_uri;
 %rename(checkIfCollection) oc_check_if_collection;
 %rename(collectionAdd) oc_collection_add;
+%ignore oc_collection_batch_set_buffer;
+%ignore oc_collection_batch_send;
 %include "oc_collection.h"
 /*******************End oc_collection.h*********************/
\ No newline at end of file
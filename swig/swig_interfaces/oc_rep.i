@@ -114,6 +114,8 @@ void newBuffer(int size) {
 
 %ignore oc_rep_get_encoded_payload_size;
 %ignore oc_rep_get_encoder_buf;
+%ignore oc_rep_get_encoder_pos;
+%ignore oc_rep_encode_raw;
 
 // DOCUMENTATION workaround
 %javamethodmodifiers jni_rep_set_double "/**
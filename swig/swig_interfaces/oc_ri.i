@@ -60,6 +60,10 @@
 %immutable oc_resource_s::num_links;
 %rename("%(lowercamelcase)s") observe_period_seconds;
 %immutable oc_resource_s::observe_period_seconds;
+%rename("%(lowercamelcase)s") coalesce_requests;
+%immutable oc_resource_s::coalesce_requests;
+%rename("%(lowercamelcase)s") response_cache_ttl;
+%immutable oc_resource_s::response_cache_ttl;
 // get/set properties callbacks are not expected to be read or writen directly to by Java code.
 %ignore oc_resource_s::get_properties;
 %ignore oc_resource_s::set_properties;
@@ -78,7 +82,11 @@
 %ignore oc_ri_alloc_resource;
 %ignore oc_ri_add_resource;
 %ignore oc_ri_delete_resource;
+%ignore oc_ri_begin_resource_batch;
+%ignore oc_ri_commit_resource_batch;
 %ignore oc_ri_free_resource_properties;
+%ignore oc_ri_release_coalesced_gets;
+%ignore oc_ri_invalidate_cached_responses;
 %ignore oc_ri_get_query_nth_key_value;
 %ignore oc_ri_get_query_value;
 %ignore oc_ri_get_interface_mask;
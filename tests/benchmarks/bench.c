@@ -0,0 +1,462 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+/* Request latency and throughput benchmarks. One process hosts a server
+ * device and drives it through the client API, either over the in-process
+ * fake connectivity layer (bench_fake) or over UDP loopback through the
+ * regular Linux adapter (bench_udp).
+ *
+ * Every scenario prints one JSON object per line:
+ *   {"benchmark":"get_small","transport":"fake","iterations":1000,
+ *    "payload_bytes":16,"failures":0,"p50_us":9,"p99_us":31,"max_us":80,
+ *    "ops_per_sec":98000.0}
+ * where iterations counts the completed ones the latencies are taken from.
+ *
+ * Usage: bench_fake [-n iterations] [-s large_payload_bytes]
+ *                   [-o observers] [-r discoverable_resources]
+ */
+
+#include "oc_api.h"
+#include "port/oc_clock.h"
+#include "port/oc_connectivity.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef OC_BENCH_FAKE_CONNECTIVITY
+#include "fake_connectivity.h"
+#define TRANSPORT "fake"
+#else /* OC_BENCH_FAKE_CONNECTIVITY */
+#define TRANSPORT "udp"
+#endif /* !OC_BENCH_FAKE_CONNECTIVITY */
+
+#define SMALL_PAYLOAD_SIZE (16)
+#define TIMEOUT_US (5000000)
+
+static int iterations = 1000;
+static size_t large_size = 4096;
+static int num_observers = 8;
+static int num_resources = 32;
+
+static uint8_t *large_payload;
+static oc_resource_t *obs_resource;
+static int obs_value;
+static int discoverable;
+
+static uint32_t *samples;
+static int pending;
+static int failures;
+/* Tags the requests of each iteration, so that a late reply to one that
+ * timed out is not counted against the next. */
+static intptr_t round_id;
+
+static uint64_t
+now_us(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec * 1000000 + (uint64_t)t.tv_nsec / 1000;
+}
+
+static int
+compare_samples(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static void
+report(const char *name, int n, size_t payload, uint64_t elapsed_us)
+{
+  qsort(samples, (size_t)n, sizeof(uint32_t), compare_samples);
+  uint32_t p50 = n ? samples[n / 2] : 0;
+  uint32_t p99 = n ? samples[(n * 99) / 100 < n ? (n * 99) / 100 : n - 1] : 0;
+  uint32_t max = n ? samples[n - 1] : 0;
+  printf("{\"benchmark\":\"%s\",\"transport\":\"%s\",\"iterations\":%d,"
+         "\"payload_bytes\":%zu,\"failures\":%d,\"p50_us\":%" PRIu32
+         ",\"p99_us\":%" PRIu32 ",\"max_us\":%" PRIu32
+         ",\"ops_per_sec\":%.1f}\n",
+         name, TRANSPORT, n, payload, failures, p50, p99, max,
+         elapsed_us ? (double)n * 1000000.0 / (double)elapsed_us : 0.0);
+  fflush(stdout);
+}
+
+/* Runs the event loop until all outstanding replies arrived. */
+static bool
+run_until_done(void)
+{
+  uint64_t deadline = now_us() + TIMEOUT_US;
+  while (pending > 0) {
+    oc_main_poll();
+    if (now_us() > deadline) {
+      pending = 0;
+      failures++;
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Lets in-flight exchanges (e.g. observe cancellations) settle. */
+static void
+drain(void)
+{
+  uint64_t deadline = now_us() + 100000;
+  while (now_us() < deadline) {
+    oc_main_poll();
+  }
+}
+
+static void
+get_small(oc_request_t *request, oc_interface_mask_t iface_mask,
+          void *user_data)
+{
+  (void)iface_mask;
+  (void)user_data;
+  uint8_t small[SMALL_PAYLOAD_SIZE] = { 0 };
+  oc_rep_start_root_object();
+  oc_rep_set_byte_string(root, d, small, sizeof(small));
+  oc_rep_end_root_object();
+  oc_send_response(request, OC_STATUS_OK);
+}
+
+static void
+get_large(oc_request_t *request, oc_interface_mask_t iface_mask,
+          void *user_data)
+{
+  (void)iface_mask;
+  (void)user_data;
+  oc_rep_start_root_object();
+  oc_rep_set_byte_string(root, d, large_payload, large_size);
+  oc_rep_end_root_object();
+  oc_send_response(request, OC_STATUS_OK);
+}
+
+static void
+post_any(oc_request_t *request, oc_interface_mask_t iface_mask,
+         void *user_data)
+{
+  (void)iface_mask;
+  (void)user_data;
+  oc_send_response(request, OC_STATUS_CHANGED);
+}
+
+static void
+get_obs(oc_request_t *request, oc_interface_mask_t iface_mask, void *user_data)
+{
+  (void)iface_mask;
+  (void)user_data;
+  oc_rep_start_root_object();
+  oc_rep_set_int(root, v, obs_value);
+  oc_rep_end_root_object();
+  oc_send_response(request, OC_STATUS_OK);
+}
+
+static oc_resource_t *
+add_resource(const char *uri, const char *rt, oc_request_callback_t get,
+             oc_request_callback_t post)
+{
+  oc_resource_t *res = oc_new_resource(NULL, uri, 1, 0);
+  if (!res) {
+    return NULL;
+  }
+  oc_resource_bind_resource_type(res, rt);
+  oc_resource_bind_resource_interface(res, OC_IF_RW);
+  oc_resource_set_default_interface(res, OC_IF_RW);
+  oc_resource_set_discoverable(res, true);
+  oc_resource_set_request_handler(res, OC_GET, get, NULL);
+  if (post) {
+    oc_resource_set_request_handler(res, OC_POST, post, NULL);
+  }
+  if (!oc_add_resource(res)) {
+    oc_delete_resource(res);
+    return NULL;
+  }
+  return res;
+}
+
+static void
+register_resources(void)
+{
+  int i;
+  add_resource("/bench/small", "x.bench.small", get_small, post_any);
+  add_resource("/bench/large", "x.bench.large", get_large, post_any);
+  obs_resource = oc_new_resource(NULL, "/bench/obs", 1, 0);
+  if (obs_resource) {
+    oc_resource_bind_resource_type(obs_resource, "x.bench.obs");
+    oc_resource_bind_resource_interface(obs_resource, OC_IF_R);
+    oc_resource_set_default_interface(obs_resource, OC_IF_R);
+    oc_resource_set_observable(obs_resource, true);
+    oc_resource_set_request_handler(obs_resource, OC_GET, get_obs, NULL);
+    if (!oc_add_resource(obs_resource)) {
+      oc_delete_resource(obs_resource);
+      obs_resource = NULL;
+    }
+  }
+  for (i = 0; i < num_resources; i++) {
+    char uri[32];
+    snprintf(uri, sizeof(uri), "/bench/r%d", i);
+    if (!add_resource(uri, "x.bench.r", get_small, NULL)) {
+      break;
+    }
+    discoverable++;
+  }
+}
+
+static int
+app_init(void)
+{
+  int ret = oc_init_platform("Bench", NULL, NULL);
+  ret |= oc_add_device("/oic/d", "oic.d.bench", "Bench", "ocf.2.0.5",
+                       "ocf.res.1.3.0,ocf.sh.1.3.0", NULL, NULL);
+  return ret;
+}
+
+static void
+signal_event_loop(void)
+{
+}
+
+static void
+server_endpoint(size_t index, oc_endpoint_t *ep)
+{
+#ifdef OC_BENCH_FAKE_CONNECTIVITY
+  fake_connectivity_server_endpoint(index, ep);
+#else  /* OC_BENCH_FAKE_CONNECTIVITY */
+  (void)index;
+  oc_endpoint_t *e = oc_connectivity_get_endpoints(0);
+  while (e && ((e->flags & (SECURED | TCP)) || !(e->flags & IPV6))) {
+    e = e->next;
+  }
+  if (e) {
+    memcpy(ep, e, sizeof(oc_endpoint_t));
+    ep->next = NULL;
+  }
+#endif /* !OC_BENCH_FAKE_CONNECTIVITY */
+}
+
+static void
+response_handler(oc_client_response_t *data)
+{
+  if ((intptr_t)data->user_data != round_id) {
+    return;
+  }
+  if (data->code != OC_STATUS_OK && data->code != OC_STATUS_CHANGED) {
+    failures++;
+  }
+  pending--;
+}
+
+static void
+bench_request(const char *name, const char *uri, oc_method_t method,
+              const uint8_t *payload, size_t payload_len)
+{
+  oc_endpoint_t ep;
+  int i, n = 0;
+  memset(&ep, 0, sizeof(ep));
+  server_endpoint(0, &ep);
+  failures = 0;
+
+  uint64_t begin = now_us();
+  for (i = 0; i < iterations; i++) {
+    uint64_t start = now_us();
+    void *tag = (void *)++round_id;
+    pending = 1;
+    if (method == OC_GET) {
+      if (!oc_do_get(uri, &ep, NULL, response_handler, HIGH_QOS, tag)) {
+        failures++;
+        continue;
+      }
+    } else {
+      if (!oc_init_post(uri, &ep, NULL, response_handler, HIGH_QOS, tag)) {
+        failures++;
+        continue;
+      }
+      oc_rep_start_root_object();
+      oc_rep_set_byte_string(root, d, payload, payload_len);
+      oc_rep_end_root_object();
+      if (!oc_do_post()) {
+        failures++;
+        continue;
+      }
+    }
+    if (run_until_done()) {
+      samples[n++] = (uint32_t)(now_us() - start);
+    }
+  }
+  report(name, n, payload_len, now_us() - begin);
+}
+
+static void
+observe_handler(oc_client_response_t *data)
+{
+  int64_t v = -1;
+  /* Notifications carry the value they were sent for, which tells a late
+   * one from an earlier iteration apart from the current one. */
+  if (!oc_rep_get_int(data->payload, "v", &v) || v != obs_value) {
+    return;
+  }
+  pending--;
+}
+
+static void
+bench_observe(void)
+{
+  oc_endpoint_t ep[64];
+  int n = num_observers, i;
+#ifndef OC_BENCH_FAKE_CONNECTIVITY
+  /* All requests leave from one socket, so the server sees a single
+   * observer however many are registered. */
+  n = 1;
+#endif /* !OC_BENCH_FAKE_CONNECTIVITY */
+  if (n > (int)(sizeof(ep) / sizeof(ep[0]))) {
+    n = (int)(sizeof(ep) / sizeof(ep[0]));
+  }
+  if (!obs_resource) {
+    return;
+  }
+  failures = 0;
+  pending = n;
+  for (i = 0; i < n; i++) {
+    memset(&ep[i], 0, sizeof(oc_endpoint_t));
+    server_endpoint((size_t)i, &ep[i]);
+    oc_do_observe("/bench/obs", &ep[i], NULL, observe_handler, LOW_QOS, NULL);
+  }
+  run_until_done();
+
+  int completed = 0;
+  uint64_t begin = now_us();
+  for (i = 0; i < iterations; i++) {
+    uint64_t start = now_us();
+    pending = n;
+    obs_value++;
+    oc_notify_observers(obs_resource);
+    if (run_until_done()) {
+      samples[completed++] = (uint32_t)(now_us() - start);
+    }
+  }
+  char name[32];
+  snprintf(name, sizeof(name), "observe_fanout_%d", n);
+  report(name, completed, sizeof(int), now_us() - begin);
+
+  for (i = 0; i < n; i++) {
+    oc_stop_observe("/bench/obs", &ep[i]);
+  }
+  drain();
+}
+
+static oc_discovery_flags_t
+discovery_handler(const char *anchor, const char *uri, oc_string_array_t types,
+                  oc_interface_mask_t iface_mask, oc_endpoint_t *endpoint,
+                  oc_resource_properties_t bm, void *user_data)
+{
+  (void)anchor;
+  (void)uri;
+  (void)types;
+  (void)iface_mask;
+  (void)endpoint;
+  (void)bm;
+  if ((intptr_t)user_data != round_id) {
+    return OC_STOP_DISCOVERY;
+  }
+  if (--pending <= 0) {
+    return OC_STOP_DISCOVERY;
+  }
+  return OC_CONTINUE_DISCOVERY;
+}
+
+static void
+bench_discovery(void)
+{
+  oc_endpoint_t ep;
+  int i, n = 0;
+  memset(&ep, 0, sizeof(ep));
+  server_endpoint(0, &ep);
+  failures = 0;
+
+  uint64_t begin = now_us();
+  for (i = 0; i < iterations; i++) {
+    uint64_t start = now_us();
+    pending = discoverable;
+    if (!oc_do_ip_discovery_at_endpoint("x.bench.r", discovery_handler, &ep,
+                                        (void *)++round_id)) {
+      failures++;
+      continue;
+    }
+    if (run_until_done()) {
+      samples[n++] = (uint32_t)(now_us() - start);
+    }
+  }
+  char name[32];
+  snprintf(name, sizeof(name), "discovery_%d", discoverable);
+  report(name, n, 0, now_us() - begin);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int i;
+  for (i = 1; i + 1 < argc; i += 2) {
+    int v = atoi(argv[i + 1]);
+    if (strcmp(argv[i], "-n") == 0 && v > 0) {
+      iterations = v;
+    } else if (strcmp(argv[i], "-s") == 0 && v > 0) {
+      large_size = (size_t)v;
+    } else if (strcmp(argv[i], "-o") == 0 && v > 0) {
+      num_observers = v;
+    } else if (strcmp(argv[i], "-r") == 0 && v >= 0) {
+      num_resources = v;
+    } else {
+      fprintf(stderr, "usage: %s [-n iterations] [-s large_payload_bytes] "
+                      "[-o observers] [-r resources]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+
+  samples = (uint32_t *)calloc((size_t)iterations, sizeof(uint32_t));
+  large_payload = (uint8_t *)calloc(1, large_size);
+  if (!samples || !large_payload) {
+    return 1;
+  }
+#ifdef OC_DYNAMIC_ALLOCATION
+  oc_set_max_app_data_size(large_size + 1024);
+#endif /* OC_DYNAMIC_ALLOCATION */
+
+  static const oc_handler_t handler = { .init = app_init,
+                                        .signal_event_loop = signal_event_loop,
+                                        .register_resources =
+                                          register_resources };
+  if (oc_main_init(&handler) < 0) {
+    return 1;
+  }
+
+  uint8_t small[SMALL_PAYLOAD_SIZE] = { 0 };
+  bench_request("get_small", "/bench/small", OC_GET, NULL, SMALL_PAYLOAD_SIZE);
+  bench_request("post_small", "/bench/small", OC_POST, small, sizeof(small));
+  bench_request("get_large", "/bench/large", OC_GET, NULL, large_size);
+  bench_request("post_large", "/bench/large", OC_POST, large_payload,
+                large_size);
+  bench_observe();
+  bench_discovery();
+
+  oc_main_shutdown();
+  free(large_payload);
+  free(samples);
+  return 0;
+}
@@ -0,0 +1,288 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+/* In-process replacement for port/linux/ipadapter.c used by the benchmarks.
+ * No sockets are opened: every outgoing message is copied into a new
+ * incoming message and queued on the network events process, so a single
+ * stack acting as both client and server talks to itself.
+ *
+ * Addresses encode the role and a peer index. Server endpoints are
+ * fd00::<i> port 5683 and client endpoints fe00::<i> port 10000. A message
+ * sent to one is delivered as coming from the other with the same index,
+ * which lets one client appear as many distinct peers (e.g. to create N
+ * observers of the same resource).
+ */
+
+#include "fake_connectivity.h"
+#include "oc_buffer.h"
+#include "oc_endpoint.h"
+#include "oc_network_events.h"
+#include "oc_session_events.h"
+#include "port/oc_connectivity.h"
+#include "port/oc_log.h"
+#include "port/oc_network_events_mutex.h"
+#include "util/oc_list.h"
+#include "util/oc_memb.h"
+#include <string.h>
+
+#define FAKE_SERVER_PREFIX (0xfd)
+#define FAKE_CLIENT_PREFIX (0xfe)
+#define FAKE_SERVER_PORT (5683)
+#define FAKE_CLIENT_PORT (10000)
+
+static oc_endpoint_t server_endpoint;
+
+#ifdef OC_NETWORK_MONITOR
+OC_LIST(oc_network_interface_cb_list);
+OC_MEMB(oc_network_interface_cb_s, oc_network_interface_cb_t,
+        OC_MAX_NETWORK_INTERFACE_CBS);
+#endif /* OC_NETWORK_MONITOR */
+
+#ifdef OC_SESSION_EVENTS
+OC_LIST(oc_session_event_cb_list);
+OC_MEMB(oc_session_event_cb_s, oc_session_event_cb_t, OC_MAX_SESSION_EVENT_CBS);
+#endif /* OC_SESSION_EVENTS */
+
+static void
+make_endpoint(oc_endpoint_t *ep, uint8_t prefix, uint16_t port, size_t index)
+{
+  memset(ep, 0, sizeof(oc_endpoint_t));
+  ep->flags = IPV6;
+  ep->addr.ipv6.address[0] = prefix;
+  ep->addr.ipv6.address[14] = (uint8_t)(index >> 8);
+  ep->addr.ipv6.address[15] = (uint8_t)index;
+  ep->addr.ipv6.port = port;
+}
+
+void
+fake_connectivity_server_endpoint(size_t index, oc_endpoint_t *endpoint)
+{
+  make_endpoint(endpoint, FAKE_SERVER_PREFIX, FAKE_SERVER_PORT, index);
+}
+
+static void
+deliver(oc_message_t *message)
+{
+  oc_message_t *in = oc_allocate_message();
+  if (!in) {
+    OC_WRN("fake connectivity: dropping message, no free buffers");
+    return;
+  }
+  const uint8_t *addr = message->endpoint.addr.ipv6.address;
+  size_t index = (size_t)(addr[14] << 8 | addr[15]);
+  if (addr[0] == FAKE_CLIENT_PREFIX) {
+    make_endpoint(&in->endpoint, FAKE_SERVER_PREFIX, FAKE_SERVER_PORT, index);
+  } else {
+    make_endpoint(&in->endpoint, FAKE_CLIENT_PREFIX, FAKE_CLIENT_PORT, index);
+  }
+  in->endpoint.device = message->endpoint.device;
+  memcpy(in->data, message->data, message->length);
+  in->length = message->length;
+  oc_network_event(in);
+}
+
+int
+oc_send_buffer(oc_message_t *message)
+{
+  deliver(message);
+  return (int)message->length;
+}
+
+/* Multicast discovery reaches the single in-process server as a unicast
+ * request, so it is answered without the multicast response delay.
+ */
+void
+oc_send_discovery_request(oc_message_t *message)
+{
+  fake_connectivity_server_endpoint(0, &message->endpoint);
+  deliver(message);
+}
+
+int
+oc_connectivity_init(size_t device)
+{
+  (void)device;
+  fake_connectivity_server_endpoint(0, &server_endpoint);
+  return 0;
+}
+
+void
+oc_connectivity_shutdown(size_t device)
+{
+  (void)device;
+}
+
+oc_endpoint_t *
+oc_connectivity_get_endpoints(size_t device)
+{
+  server_endpoint.device = device;
+  return &server_endpoint;
+}
+
+void
+oc_connectivity_end_session(oc_endpoint_t *endpoint)
+{
+  (void)endpoint;
+}
+
+#ifdef OC_DNS_LOOKUP
+int
+oc_dns_lookup(const char *domain, oc_string_t *addr, enum transport_flags flags)
+{
+  (void)domain;
+  (void)addr;
+  (void)flags;
+  return -1;
+}
+#endif /* OC_DNS_LOOKUP */
+
+#ifdef OC_TCP
+tcp_csm_state_t
+oc_tcp_get_csm_state(oc_endpoint_t *endpoint)
+{
+  (void)endpoint;
+  return CSM_DONE;
+}
+
+int
+oc_tcp_update_csm_state(oc_endpoint_t *endpoint, tcp_csm_state_t csm)
+{
+  (void)endpoint;
+  (void)csm;
+  return 0;
+}
+#endif /* OC_TCP */
+
+/* Everything runs on the event loop thread. */
+void
+oc_network_event_handler_mutex_init(void)
+{
+}
+
+void
+oc_network_event_handler_mutex_lock(void)
+{
+}
+
+void
+oc_network_event_handler_mutex_unlock(void)
+{
+}
+
+void
+oc_network_event_handler_mutex_destroy(void)
+{
+#ifdef OC_NETWORK_MONITOR
+  oc_network_interface_cb_t *cb;
+  while ((cb = oc_list_pop(oc_network_interface_cb_list)) != NULL) {
+    oc_memb_free(&oc_network_interface_cb_s, cb);
+  }
+#endif /* OC_NETWORK_MONITOR */
+#ifdef OC_SESSION_EVENTS
+  oc_session_event_cb_t *scb;
+  while ((scb = oc_list_pop(oc_session_event_cb_list)) != NULL) {
+    oc_memb_free(&oc_session_event_cb_s, scb);
+  }
+#endif /* OC_SESSION_EVENTS */
+}
+
+#ifdef OC_NETWORK_MONITOR
+int
+oc_add_network_interface_event_callback(interface_event_handler_t cb)
+{
+  if (!cb)
+    return -1;
+
+  oc_network_interface_cb_t *cb_item =
+    oc_memb_alloc(&oc_network_interface_cb_s);
+  if (!cb_item) {
+    return -1;
+  }
+  cb_item->handler = cb;
+  oc_list_add(oc_network_interface_cb_list, cb_item);
+  return 0;
+}
+
+int
+oc_remove_network_interface_event_callback(interface_event_handler_t cb)
+{
+  oc_network_interface_cb_t *cb_item =
+    oc_list_head(oc_network_interface_cb_list);
+  while (cb_item != NULL && cb_item->handler != cb) {
+    cb_item = cb_item->next;
+  }
+  if (!cb_item) {
+    return -1;
+  }
+  oc_list_remove(oc_network_interface_cb_list, cb_item);
+  oc_memb_free(&oc_network_interface_cb_s, cb_item);
+  return 0;
+}
+
+void
+handle_network_interface_event_callback(oc_interface_event_t event)
+{
+  oc_network_interface_cb_t *cb_item =
+    oc_list_head(oc_network_interface_cb_list);
+  while (cb_item) {
+    cb_item->handler(event);
+    cb_item = cb_item->next;
+  }
+}
+#endif /* OC_NETWORK_MONITOR */
+
+#ifdef OC_SESSION_EVENTS
+int
+oc_add_session_event_callback(session_event_handler_t cb)
+{
+  if (!cb)
+    return -1;
+
+  oc_session_event_cb_t *cb_item = oc_memb_alloc(&oc_session_event_cb_s);
+  if (!cb_item) {
+    return -1;
+  }
+  cb_item->handler = cb;
+  oc_list_add(oc_session_event_cb_list, cb_item);
+  return 0;
+}
+
+int
+oc_remove_session_event_callback(session_event_handler_t cb)
+{
+  oc_session_event_cb_t *cb_item = oc_list_head(oc_session_event_cb_list);
+  while (cb_item != NULL && cb_item->handler != cb) {
+    cb_item = cb_item->next;
+  }
+  if (!cb_item) {
+    return -1;
+  }
+  oc_list_remove(oc_session_event_cb_list, cb_item);
+  oc_memb_free(&oc_session_event_cb_s, cb_item);
+  return 0;
+}
+
+void
+handle_session_event_callback(const oc_endpoint_t *endpoint,
+                              oc_session_state_t state)
+{
+  oc_session_event_cb_t *cb_item = oc_list_head(oc_session_event_cb_list);
+  while (cb_item) {
+    cb_item->handler(endpoint, state);
+    cb_item = cb_item->next;
+  }
+}
+#endif /* OC_SESSION_EVENTS */
@@ -0,0 +1,35 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#ifndef FAKE_CONNECTIVITY_H
+#define FAKE_CONNECTIVITY_H
+
+#include "oc_endpoint.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Endpoint of the in-process server as seen by peer number index. Requests
+ * sent to different indices arrive from different client endpoints.
+ */
+void fake_connectivity_server_endpoint(size_t index, oc_endpoint_t *endpoint);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FAKE_CONNECTIVITY_H */
@@ -0,0 +1,353 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+/* Encode/decode benchmarks for oc_rep over a corpus shaped like real OCF
+ * payloads: /oic/res link arrays, collection batch responses, /oic/sec/acl2
+ * and /oic/sec/cred documents, and large int and string arrays. Each corpus
+ * entry is produced with the oc_rep_* macros, so the encoding path is
+ * measured as well.
+ *
+ * One JSON object is printed per corpus entry:
+ *   {"corpus":"discovery_200","payload_bytes":...,"allocs":...,
+ *    "encode_ns":...,"parse_ns":...,"free_ns":...,"to_json_ns":...,
+ *    "json_bytes":...}
+ * "allocs" counts the oc_rep_t nodes plus the string and array buffers
+ * allocated by one oc_parse_rep() call. The larger entries need a build
+ * with OC_DYNAMIC_ALLOCATION; the static byte pools cannot hold them.
+ *
+ * Usage: bench_rep [-n iterations]
+ */
+
+#include "oc_rep.h"
+#include "oc_helpers.h"
+#include "util/oc_memb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PAYLOAD_BUFFER_SIZE (256 * 1024)
+
+OC_MEMB(rep_objects, oc_rep_t, 8192);
+
+static uint8_t *payload;
+static char *json;
+static long iterations = 1000;
+
+static uint64_t
+now_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+/* Corpus ------------------------------------------------------------------*/
+
+static void
+encode_discovery(int num_links)
+{
+  int i;
+  char href[32];
+  oc_rep_start_links_array();
+  for (i = 0; i < num_links; i++) {
+    CborEncoder *links = &links_array;
+    snprintf(href, sizeof(href), "/a/light/%d", i);
+    oc_rep_start_object(links, link);
+    oc_rep_set_text_string(link, anchor,
+                           "ocf://4a6b2b7e-0a4f-4bbd-6f2c-7d4a1f0c3e21");
+    oc_rep_set_text_string(link, href, href);
+    oc_rep_set_array(link, rt);
+    oc_rep_add_text_string(rt, "oic.r.switch.binary");
+    oc_rep_add_text_string(rt, "oic.r.light.brightness");
+    oc_rep_close_array(link, rt);
+    oc_rep_set_array(link, if);
+    oc_rep_add_text_string(if, "oic.if.baseline");
+    oc_rep_add_text_string(if, "oic.if.a");
+    oc_rep_close_array(link, if);
+    oc_rep_set_object(link, p);
+    oc_rep_set_uint(p, bm, 3);
+    oc_rep_close_object(link, p);
+    oc_rep_set_array(link, eps);
+    oc_rep_object_array_start_item(eps);
+    oc_rep_set_text_string(eps, ep, "coaps://[fe80::b1d6:c32c:e6c3:1]:53422");
+    oc_rep_object_array_end_item(eps);
+    oc_rep_object_array_start_item(eps);
+    oc_rep_set_text_string(eps, ep,
+                           "coaps+tcp://[fe80::b1d6:c32c:e6c3:1]:41127");
+    oc_rep_object_array_end_item(eps);
+    oc_rep_close_array(link, eps);
+    oc_rep_end_object(links, link);
+  }
+  oc_rep_end_links_array();
+}
+
+static void
+encode_discovery_200(void)
+{
+  encode_discovery(200);
+}
+
+static void
+encode_discovery_20(void)
+{
+  encode_discovery(20);
+}
+
+static void
+encode_batch_32(void)
+{
+  int i;
+  char href[48];
+  oc_rep_start_links_array();
+  for (i = 0; i < 32; i++) {
+    CborEncoder *links = &links_array;
+    snprintf(href, sizeof(href),
+             "ocf://4a6b2b7e-0a4f-4bbd-6f2c-7d4a1f0c3e21/a/light/%d", i);
+    oc_rep_start_object(links, item);
+    oc_rep_set_text_string(item, href, href);
+    oc_rep_set_object(item, rep);
+    oc_rep_set_boolean(rep, value, i % 2);
+    oc_rep_set_int(rep, brightness, i * 3);
+    oc_rep_set_text_string(rep, n, "Living room light");
+    oc_rep_close_object(item, rep);
+    oc_rep_end_object(links, item);
+  }
+  oc_rep_end_links_array();
+}
+
+static void
+encode_acl2_32(void)
+{
+  int i;
+  oc_rep_start_root_object();
+  oc_rep_set_array(root, aclist2);
+  for (i = 0; i < 32; i++) {
+    oc_rep_object_array_start_item(aclist2);
+    oc_rep_set_int(aclist2, aceid, i + 1);
+    oc_rep_set_object(aclist2, subject);
+    if (i % 2) {
+      oc_rep_set_text_string(subject, uuid,
+                             "1b0a3e3a-7d34-4f5b-5e2b-3c1a4e6d7f80");
+    } else {
+      oc_rep_set_text_string(subject, conntype, "anon-clear");
+    }
+    oc_rep_close_object(aclist2, subject);
+    oc_rep_set_array(aclist2, resources);
+    oc_rep_object_array_start_item(resources);
+    oc_rep_set_text_string(resources, href, "/a/light");
+    oc_rep_object_array_end_item(resources);
+    oc_rep_object_array_start_item(resources);
+    oc_rep_set_text_string(resources, wc, "*");
+    oc_rep_object_array_end_item(resources);
+    oc_rep_close_array(aclist2, resources);
+    oc_rep_set_uint(aclist2, permission, 31);
+    oc_rep_object_array_end_item(aclist2);
+  }
+  oc_rep_close_array(root, aclist2);
+  oc_rep_set_text_string(root, rowneruuid,
+                         "4a6b2b7e-0a4f-4bbd-6f2c-7d4a1f0c3e21");
+  oc_rep_end_root_object();
+}
+
+static void
+encode_cred_16(void)
+{
+  int i;
+  uint8_t key[16];
+  memset(key, 0xa5, sizeof(key));
+  oc_rep_start_root_object();
+  oc_rep_set_array(root, creds);
+  for (i = 0; i < 16; i++) {
+    oc_rep_object_array_start_item(creds);
+    oc_rep_set_int(creds, credid, i + 1);
+    oc_rep_set_text_string(creds, subjectuuid,
+                           "1b0a3e3a-7d34-4f5b-5e2b-3c1a4e6d7f80");
+    oc_rep_set_int(creds, credtype, 1);
+    oc_rep_set_object(creds, privatedata);
+    oc_rep_set_byte_string(privatedata, data, key, sizeof(key));
+    oc_rep_set_text_string(privatedata, encoding, "oic.sec.encoding.raw");
+    oc_rep_close_object(creds, privatedata);
+    oc_rep_set_text_string(creds, credusage, "oic.sec.cred.mfgcert");
+    oc_rep_object_array_end_item(creds);
+  }
+  oc_rep_close_array(root, creds);
+  oc_rep_set_text_string(root, rowneruuid,
+                         "4a6b2b7e-0a4f-4bbd-6f2c-7d4a1f0c3e21");
+  oc_rep_end_root_object();
+}
+
+static void
+encode_arrays(void)
+{
+  static int64_t ints[1024];
+  int i;
+  for (i = 0; i < 1024; i++) {
+    ints[i] = (int64_t)i * 7919;
+  }
+  oc_rep_start_root_object();
+  oc_rep_set_int_array(root, samples, ints, 1024);
+  oc_rep_set_array(root, names);
+  for (i = 0; i < 64; i++) {
+    oc_rep_add_text_string(names, "oic.r.temperature.sensor");
+  }
+  oc_rep_close_array(root, names);
+  oc_rep_set_text_string(root, description,
+                         "Lorem ipsum dolor sit amet, consectetur adipiscing "
+                         "elit, sed do eiusmod tempor incididunt ut labore et "
+                         "dolore magna aliqua. Ut enim ad minim veniam, quis "
+                         "nostrud exercitation ullamco laboris nisi ut aliquip "
+                         "ex ea commodo consequat.");
+  oc_rep_end_root_object();
+}
+
+typedef struct
+{
+  const char *name;
+  void (*encode)(void);
+} corpus_entry_t;
+
+static const corpus_entry_t corpus[] = {
+  { "discovery_20", encode_discovery_20 },
+  { "discovery_200", encode_discovery_200 },
+  { "batch_32", encode_batch_32 },
+  { "acl2_32", encode_acl2_32 },
+  { "cred_16", encode_cred_16 },
+  { "arrays_1024", encode_arrays },
+};
+
+/* Harness -----------------------------------------------------------------*/
+
+static long
+count_allocs(oc_rep_t *rep)
+{
+  long n = 0;
+  for (; rep; rep = rep->next) {
+    n++;
+    if (oc_string_len(rep->name) > 0) {
+      n++;
+    }
+    switch (rep->type) {
+    case OC_REP_STRING:
+    case OC_REP_BYTE_STRING:
+    case OC_REP_INT_ARRAY:
+    case OC_REP_DOUBLE_ARRAY:
+    case OC_REP_BOOL_ARRAY:
+    case OC_REP_STRING_ARRAY:
+    case OC_REP_BYTE_STRING_ARRAY:
+      n++;
+      break;
+    case OC_REP_OBJECT:
+      n += count_allocs(rep->value.object);
+      break;
+    case OC_REP_OBJECT_ARRAY:
+      n += count_allocs(rep->value.object_array);
+      break;
+    default:
+      break;
+    }
+  }
+  return n;
+}
+
+static int
+encode(const corpus_entry_t *entry)
+{
+  oc_rep_new(payload, PAYLOAD_BUFFER_SIZE);
+  entry->encode();
+  return oc_rep_get_encoded_payload_size();
+}
+
+static void
+run(const corpus_entry_t *entry)
+{
+  uint64_t encode_ns = 0, parse_ns = 0, free_ns = 0, json_ns = 0, t;
+  size_t json_len = 0;
+  long allocs = 0, i;
+  int size = 0;
+
+  for (i = 0; i < iterations; i++) {
+    oc_rep_t *rep = NULL;
+
+    t = now_ns();
+    size = encode(entry);
+    encode_ns += now_ns() - t;
+    if (size <= 0) {
+      fprintf(stderr, "%s: encoding failed\n", entry->name);
+      return;
+    }
+
+    t = now_ns();
+    if (oc_parse_rep(payload, size, &rep) != 0) {
+      fprintf(stderr, "%s: parsing failed\n", entry->name);
+      oc_free_rep(rep);
+      return;
+    }
+    parse_ns += now_ns() - t;
+
+    if (i == 0) {
+      allocs = count_allocs(rep);
+      json_len = oc_rep_to_json(rep, NULL, 0, false);
+      json = (char *)realloc(json, json_len + 1);
+      if (!json) {
+        return;
+      }
+    }
+
+    t = now_ns();
+    oc_rep_to_json(rep, json, json_len + 1, false);
+    json_ns += now_ns() - t;
+
+    t = now_ns();
+    oc_free_rep(rep);
+    free_ns += now_ns() - t;
+  }
+
+  printf("{\"corpus\":\"%s\",\"payload_bytes\":%d,\"allocs\":%ld,"
+         "\"encode_ns\":%.0f,\"parse_ns\":%.0f,\"free_ns\":%.0f,"
+         "\"to_json_ns\":%.0f,\"json_bytes\":%zu}\n",
+         entry->name, size, allocs, (double)encode_ns / iterations,
+         (double)parse_ns / iterations, (double)free_ns / iterations,
+         (double)json_ns / iterations, json_len);
+  fflush(stdout);
+}
+
+int
+main(int argc, char *argv[])
+{
+  size_t i;
+  if (argc == 3 && strcmp(argv[1], "-n") == 0 && atol(argv[2]) > 0) {
+    iterations = atol(argv[2]);
+  } else if (argc != 1) {
+    fprintf(stderr, "usage: %s [-n iterations]\n", argv[0]);
+    return 1;
+  }
+
+  payload = (uint8_t *)malloc(PAYLOAD_BUFFER_SIZE);
+  if (!payload) {
+    return 1;
+  }
+  oc_memb_init(&rep_objects);
+  oc_rep_set_pool(&rep_objects);
+
+  for (i = 0; i < sizeof(corpus) / sizeof(corpus[0]); i++) {
+    run(&corpus[i]);
+  }
+
+  free(json);
+  free(payload);
+  return 0;
+}
@@ -0,0 +1,298 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+/* Microbenchmarks for the containers and schedulers in util/. The binary
+ * is built twice, once with static pools (bench_util) and once with
+ * OC_DYNAMIC_ALLOCATION (bench_util_dynamic), and prints one JSON object per
+ * case:
+ *   {"benchmark":"memb_fill_drain_256","alloc":"static","ops":...,
+ *    "ns_per_op":...,"ops_per_sec":...}
+ *
+ * Usage: bench_util [-n operations]
+ */
+
+#include "port/oc_clock.h"
+#include "util/oc_etimer.h"
+#include "util/oc_list.h"
+#include "util/oc_memb.h"
+#include "util/oc_mmem.h"
+#include "util/oc_process.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef OC_DYNAMIC_ALLOCATION
+#define ALLOC "dynamic"
+#else /* OC_DYNAMIC_ALLOCATION */
+#define ALLOC "static"
+#endif /* !OC_DYNAMIC_ALLOCATION */
+
+#define MAX_ITEMS (4096)
+#define NUM_TIMERS (2048)
+#define EVENT_BATCH (8)
+
+static long ops = 1000000;
+
+typedef struct bench_item_s
+{
+  struct bench_item_s *next;
+  uint8_t payload[56];
+} bench_item_t;
+
+static bench_item_t *items[MAX_ITEMS];
+
+static uint64_t
+now_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+static void
+report(const char *name, long n, uint64_t elapsed_ns)
+{
+  printf("{\"benchmark\":\"%s\",\"alloc\":\"%s\",\"ops\":%ld,"
+         "\"ns_per_op\":%.1f,\"ops_per_sec\":%.1f}\n",
+         name, ALLOC, n, n ? (double)elapsed_ns / (double)n : 0.0,
+         elapsed_ns ? (double)n * 1e9 / (double)elapsed_ns : 0.0);
+  fflush(stdout);
+}
+
+/* oc_memb ------------------------------------------------------------------*/
+
+OC_MEMB(pool_16, bench_item_t, 16);
+OC_MEMB(pool_256, bench_item_t, 256);
+OC_MEMB(pool_4096, bench_item_t, MAX_ITEMS);
+
+/* Allocate and immediately release one block. */
+static void
+bench_memb_pair(const char *name, struct oc_memb *pool)
+{
+  long i;
+  uint64_t start = now_ns();
+  for (i = 0; i < ops; i++) {
+    bench_item_t *item = (bench_item_t *)oc_memb_alloc(pool);
+    oc_memb_free(pool, item);
+  }
+  report(name, ops, now_ns() - start);
+}
+
+/* Fill the whole pool, then release the blocks oldest first. */
+static void
+bench_memb_fill_drain(const char *name, struct oc_memb *pool, int size)
+{
+  long done = 0;
+  int i;
+  uint64_t start = now_ns();
+  while (done < ops) {
+    for (i = 0; i < size; i++) {
+      items[i] = (bench_item_t *)oc_memb_alloc(pool);
+    }
+    for (i = 0; i < size; i++) {
+      oc_memb_free(pool, items[i]);
+    }
+    done += 2 * size;
+  }
+  report(name, done, now_ns() - start);
+}
+
+/* oc_mmem ------------------------------------------------------------------*/
+
+#define LIVE_STRINGS (16)
+
+/* Keeps LIVE_STRINGS strings of varying length alive and replaces the
+ * oldest one on every step, which makes the static byte pool compact. */
+static void
+bench_mmem_churn(void)
+{
+  struct oc_mmem live[LIVE_STRINGS];
+  long i;
+  int j;
+  memset(live, 0, sizeof(live));
+  for (j = 0; j < LIVE_STRINGS; j++) {
+    oc_mmem_alloc(&live[j], (size_t)(8 + j * 3 % 33), BYTE_POOL);
+  }
+  uint64_t start = now_ns();
+  for (i = 0; i < ops; i++) {
+    j = (int)(i % LIVE_STRINGS);
+    oc_mmem_free(&live[j], BYTE_POOL);
+    oc_mmem_alloc(&live[j], (size_t)(8 + i * 7 % 33), BYTE_POOL);
+  }
+  report("mmem_string_churn", 2 * ops, now_ns() - start);
+  for (j = 0; j < LIVE_STRINGS; j++) {
+    if (live[j].ptr) {
+      oc_mmem_free(&live[j], BYTE_POOL);
+    }
+  }
+}
+
+/* oc_list ------------------------------------------------------------------*/
+
+OC_LIST(bench_list);
+static bench_item_t list_items[MAX_ITEMS];
+
+static void
+bench_list_ops(int size)
+{
+  char name[48];
+  long done = 0;
+  int i;
+
+  uint64_t start = now_ns();
+  while (done < ops) {
+    for (i = 0; i < size; i++) {
+      oc_list_add(bench_list, &list_items[i]);
+    }
+    oc_list_init(bench_list);
+    done += size;
+  }
+  snprintf(name, sizeof(name), "list_add_tail_%d", size);
+  report(name, done, now_ns() - start);
+
+  for (i = 0; i < size; i++) {
+    oc_list_add(bench_list, &list_items[i]);
+  }
+  done = 0;
+  start = now_ns();
+  while (done < ops) {
+    /* Remove from the middle and re-append. */
+    bench_item_t *item = &list_items[(done * 7919) % size];
+    oc_list_remove(bench_list, item);
+    oc_list_add(bench_list, item);
+    done++;
+  }
+  snprintf(name, sizeof(name), "list_remove_add_%d", size);
+  report(name, done, now_ns() - start);
+  oc_list_init(bench_list);
+}
+
+/* oc_process / oc_etimer ---------------------------------------------------*/
+
+static long events_seen;
+static struct oc_etimer timers[NUM_TIMERS];
+
+OC_PROCESS(bench_process, "bench");
+OC_PROCESS_THREAD(bench_process, ev, data)
+{
+  (void)ev;
+  (void)data;
+  OC_PROCESS_BEGIN();
+  while (1) {
+    OC_PROCESS_YIELD();
+    events_seen++;
+  }
+  OC_PROCESS_END();
+}
+
+static void
+run_until(long target)
+{
+  while (events_seen < target) {
+    oc_process_run();
+  }
+}
+
+static void
+bench_process_post(void)
+{
+  oc_process_event_t ev = oc_process_alloc_event();
+  long i;
+  int j;
+  events_seen = 0;
+  uint64_t start = now_ns();
+  for (i = 0; i < ops; i += EVENT_BATCH) {
+    for (j = 0; j < EVENT_BATCH; j++) {
+      oc_process_post(&bench_process, ev, NULL);
+    }
+    run_until(i + EVENT_BATCH);
+  }
+  report("process_post_run", events_seen, now_ns() - start);
+}
+
+static void
+bench_etimer(void)
+{
+  long done = 0;
+  int i;
+
+  uint64_t start = now_ns();
+  while (done < ops) {
+    OC_PROCESS_CONTEXT_BEGIN(&bench_process);
+    for (i = 0; i < NUM_TIMERS; i++) {
+      oc_etimer_set(&timers[i], OC_CLOCK_SECOND * 60 + i);
+    }
+    OC_PROCESS_CONTEXT_END(&bench_process);
+    for (i = 0; i < NUM_TIMERS; i++) {
+      oc_etimer_stop(&timers[i]);
+    }
+    done += 2 * NUM_TIMERS;
+  }
+  report("etimer_set_stop_2048", done, now_ns() - start);
+
+  /* Already-expired timers, delivered through the etimer process. */
+  done = 0;
+  events_seen = 0;
+  start = now_ns();
+  while (done < ops) {
+    OC_PROCESS_CONTEXT_BEGIN(&bench_process);
+    for (i = 0; i < NUM_TIMERS; i++) {
+      oc_etimer_set(&timers[i], 0);
+    }
+    OC_PROCESS_CONTEXT_END(&bench_process);
+    oc_etimer_request_poll();
+    run_until(events_seen + NUM_TIMERS);
+    done += NUM_TIMERS;
+  }
+  report("etimer_expiry_2048", done, now_ns() - start);
+}
+
+int
+main(int argc, char *argv[])
+{
+  if (argc == 3 && strcmp(argv[1], "-n") == 0 && atol(argv[2]) > 0) {
+    ops = atol(argv[2]);
+  } else if (argc != 1) {
+    fprintf(stderr, "usage: %s [-n operations]\n", argv[0]);
+    return 1;
+  }
+
+  oc_clock_init();
+  oc_mmem_init();
+  oc_memb_init(&pool_16);
+  oc_memb_init(&pool_256);
+  oc_memb_init(&pool_4096);
+  oc_process_init();
+  oc_process_start(&oc_etimer_process, NULL);
+  oc_process_start(&bench_process, NULL);
+  while (oc_process_run()) {
+  }
+
+  bench_memb_pair("memb_alloc_free_16", &pool_16);
+  bench_memb_pair("memb_alloc_free_4096", &pool_4096);
+  bench_memb_fill_drain("memb_fill_drain_16", &pool_16, 16);
+  bench_memb_fill_drain("memb_fill_drain_256", &pool_256, 256);
+  bench_memb_fill_drain("memb_fill_drain_4096", &pool_4096, MAX_ITEMS);
+  bench_mmem_churn();
+  bench_list_ops(64);
+  bench_list_ops(MAX_ITEMS);
+  bench_process_post();
+  bench_etimer();
+
+  oc_process_shutdown();
+  return 0;
+}
@@ -0,0 +1,246 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#ifdef OC_MEMORY_BUDGET
+#include "oc_mem_budget.h"
+#include "oc_config.h"
+#include "port/oc_log.h"
+
+/* Messages are allocated on the network thread, everything else on the
+ * event loop, so the counters are relaxed atomics where the compiler offers
+ * them. Eviction only ever runs on the event loop.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define BUDGET_ADD(var, delta)                                                 \
+  __atomic_add_fetch(&(var), (delta), __ATOMIC_RELAXED)
+#define BUDGET_SUB(var, delta)                                                 \
+  __atomic_sub_fetch(&(var), (delta), __ATOMIC_RELAXED)
+#define BUDGET_LOAD(var) __atomic_load_n(&(var), __ATOMIC_RELAXED)
+#define BUDGET_STORE(var, val) __atomic_store_n(&(var), (val), __ATOMIC_RELAXED)
+#define BUDGET_OR(var, bits) __atomic_fetch_or(&(var), (bits), __ATOMIC_RELAXED)
+#define BUDGET_TAKE(var) __atomic_exchange_n(&(var), 0, __ATOMIC_RELAXED)
+#define BUDGET_RAISE(var, val)                                                 \
+  do {                                                                         \
+    size_t _old = __atomic_load_n(&(var), __ATOMIC_RELAXED);                   \
+    while (_old < (val) &&                                                     \
+           !__atomic_compare_exchange_n(&(var), &_old, (val), true,            \
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED))   \
+      ;                                                                        \
+  } while (0)
+#else /* __GNUC__ || __clang__ */
+#define BUDGET_ADD(var, delta) ((var) += (delta))
+#define BUDGET_SUB(var, delta) ((var) -= (delta))
+#define BUDGET_LOAD(var) (var)
+#define BUDGET_STORE(var, val) ((var) = (val))
+#define BUDGET_OR(var, bits) ((var) |= (bits))
+static uint32_t
+budget_take(uint32_t *var)
+{
+  uint32_t val = *var;
+  *var = 0;
+  return val;
+}
+#define BUDGET_TAKE(var) budget_take(&(var))
+#define BUDGET_RAISE(var, val)                                                 \
+  do {                                                                         \
+    if ((var) < (val))                                                         \
+      (var) = (val);                                                           \
+  } while (0)
+#endif /* !__GNUC__ && !__clang__ */
+
+typedef struct
+{
+  size_t current;
+  size_t peak;
+  size_t soft_limit;
+  size_t hard_limit;
+  uint32_t rejected;
+  uint32_t evicted;
+} budget_t;
+
+static budget_t budgets[OC_MEM_NUM_SUBSYSTEMS];
+/* One bit per subsystem that went over its soft limit. */
+static uint32_t pending_eviction;
+/* One bit per subsystem charged with oc_mem_budget_force_charge(). */
+static uint32_t force_charged;
+static oc_mem_evict_cb_t evictors[OC_MEM_NUM_SUBSYSTEMS];
+static oc_mem_pressure_cb_t pressure_cb;
+
+static const char *subsystem_names[OC_MEM_NUM_SUBSYSTEMS] = {
+  "messages", "observers", "tls_peers", "blockwise", "rep", "strings"
+};
+
+static void
+account(oc_mem_subsystem_t subsystem, size_t current)
+{
+  budget_t *b = &budgets[subsystem];
+  size_t soft_limit = BUDGET_LOAD(b->soft_limit);
+
+  BUDGET_RAISE(b->peak, current);
+  if (soft_limit > 0 && current > soft_limit) {
+    BUDGET_OR(pending_eviction, 1u << subsystem);
+  }
+}
+
+bool
+oc_mem_budget_charge(oc_mem_subsystem_t subsystem, size_t size)
+{
+  budget_t *b = &budgets[subsystem];
+  size_t hard_limit = BUDGET_LOAD(b->hard_limit);
+  size_t current = BUDGET_ADD(b->current, size);
+
+  if (hard_limit > 0 && current > hard_limit) {
+    BUDGET_SUB(b->current, size);
+    BUDGET_ADD(b->rejected, 1);
+    OC_WRN("memory budget: %s hard limit reached",
+           subsystem_names[subsystem]);
+    return false;
+  }
+  account(subsystem, current);
+  return true;
+}
+
+void
+oc_mem_budget_force_charge(oc_mem_subsystem_t subsystem, size_t size)
+{
+  BUDGET_OR(force_charged, 1u << subsystem);
+  account(subsystem, BUDGET_ADD(budgets[subsystem].current, size));
+}
+
+void
+oc_mem_budget_release(oc_mem_subsystem_t subsystem, size_t size)
+{
+  BUDGET_SUB(budgets[subsystem].current, size);
+}
+
+bool
+oc_mem_budget_exhausted(void)
+{
+  /* Force-charged memory may be held by the application indefinitely and has
+   * no evictor, so refusing messages on its account would never recover.
+   */
+  uint32_t forced = BUDGET_LOAD(force_charged);
+  int i;
+  for (i = 0; i < OC_MEM_NUM_SUBSYSTEMS; i++) {
+    if (forced & (1u << i)) {
+      continue;
+    }
+    size_t hard_limit = BUDGET_LOAD(budgets[i].hard_limit);
+    if (hard_limit > 0 && BUDGET_LOAD(budgets[i].current) >= hard_limit) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void
+oc_mem_budget_set_evictor(oc_mem_subsystem_t subsystem,
+                          oc_mem_evict_cb_t evict)
+{
+  evictors[subsystem] = evict;
+}
+
+void
+oc_mem_budget_evict(void)
+{
+  uint32_t pending = BUDGET_TAKE(pending_eviction);
+  int i;
+
+  for (i = 0; pending != 0 && i < OC_MEM_NUM_SUBSYSTEMS; i++) {
+    budget_t *b = &budgets[i];
+    size_t soft_limit = BUDGET_LOAD(b->soft_limit);
+
+    if (!(pending & (1u << i))) {
+      continue;
+    }
+    pending &= ~(1u << i);
+    while (soft_limit > 0 && BUDGET_LOAD(b->current) > soft_limit &&
+           evictors[i] && evictors[i]()) {
+      BUDGET_ADD(b->evicted, 1);
+    }
+    if (soft_limit > 0 && BUDGET_LOAD(b->current) > soft_limit) {
+      OC_DBG("memory budget: %s still above its soft limit",
+             subsystem_names[i]);
+      if (pressure_cb) {
+        oc_mem_usage_t usage;
+        oc_mem_budget_get_usage((oc_mem_subsystem_t)i, &usage);
+        pressure_cb((oc_mem_subsystem_t)i, &usage);
+      }
+    }
+  }
+}
+
+int
+oc_mem_budget_set_limits(oc_mem_subsystem_t subsystem, size_t soft_limit,
+                         size_t hard_limit)
+{
+  if ((int)subsystem < 0 || subsystem >= OC_MEM_NUM_SUBSYSTEMS ||
+      (hard_limit > 0 && soft_limit > hard_limit)) {
+    return -1;
+  }
+  budget_t *b = &budgets[subsystem];
+  BUDGET_STORE(b->soft_limit, soft_limit);
+  BUDGET_STORE(b->hard_limit, hard_limit);
+  if (soft_limit > 0 && BUDGET_LOAD(b->current) > soft_limit) {
+    BUDGET_OR(pending_eviction, 1u << subsystem);
+  }
+  return 0;
+}
+
+int
+oc_mem_budget_get_usage(oc_mem_subsystem_t subsystem, oc_mem_usage_t *out)
+{
+  if ((int)subsystem < 0 || subsystem >= OC_MEM_NUM_SUBSYSTEMS || !out) {
+    return -1;
+  }
+  budget_t *b = &budgets[subsystem];
+  out->current = BUDGET_LOAD(b->current);
+  out->peak = BUDGET_LOAD(b->peak);
+  out->soft_limit = BUDGET_LOAD(b->soft_limit);
+  out->hard_limit = BUDGET_LOAD(b->hard_limit);
+  out->rejected = BUDGET_LOAD(b->rejected);
+  out->evicted = BUDGET_LOAD(b->evicted);
+  return 0;
+}
+
+const char *
+oc_mem_budget_subsystem_name(oc_mem_subsystem_t subsystem)
+{
+  if ((int)subsystem < 0 || subsystem >= OC_MEM_NUM_SUBSYSTEMS) {
+    return NULL;
+  }
+  return subsystem_names[subsystem];
+}
+
+void
+oc_mem_budget_reset_peaks(void)
+{
+  int i;
+  for (i = 0; i < OC_MEM_NUM_SUBSYSTEMS; i++) {
+    BUDGET_STORE(budgets[i].peak, BUDGET_LOAD(budgets[i].current));
+    BUDGET_STORE(budgets[i].rejected, 0);
+    BUDGET_STORE(budgets[i].evicted, 0);
+  }
+}
+
+void
+oc_mem_budget_set_pressure_cb(oc_mem_pressure_cb_t cb)
+{
+  pressure_cb = cb;
+}
+#else  /* OC_MEMORY_BUDGET */
+typedef int dummy_declaration;
+#endif /* !OC_MEMORY_BUDGET */
@@ -0,0 +1,147 @@
+/*
+// Copyright (c) 2026 The IoTivity-Lite Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+/**
+  @file
+
+  Memory budgets: per-subsystem accounting of the memory held by messages,
+  observers, (D)TLS peers, block-wise transfers, parsed representations and
+  oc_mmem strings and arrays, with an optional soft and hard limit each.
+
+  Crossing a soft limit schedules eviction, which runs from oc_main_poll():
+  the least recently active DTLS peers and the oldest block-wise transfers
+  are released until usage falls back under the limit, and the application
+  is notified through the callback set with oc_mem_budget_set_pressure_cb().
+  Reaching a hard limit fails the allocation, so the new message, observer,
+  peer, transfer or payload is rejected, and incoming messages are refused
+  until usage drops. Strings cannot fail where they are allocated and have
+  no evictor, so their hard limit is not enforced; watch them with a soft
+  limit and the pressure callback instead.
+
+  Accounting compiles down to nothing unless the stack is built with
+  OC_MEMORY_BUDGET. All limits default to 0 (unlimited).
+*/
+#ifndef OC_MEM_BUDGET_H
+#define OC_MEM_BUDGET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  OC_MEM_MESSAGES = 0,
+  OC_MEM_OBSERVERS,
+  OC_MEM_TLS_PEERS,
+  OC_MEM_BLOCKWISE,
+  OC_MEM_REP,
+  OC_MEM_STRINGS,
+  OC_MEM_NUM_SUBSYSTEMS
+} oc_mem_subsystem_t;
+
+typedef struct
+{
+  size_t current;    ///< bytes currently held
+  size_t peak;       ///< highest value of current since the last reset
+  size_t soft_limit; ///< 0 if unlimited
+  size_t hard_limit; ///< 0 if unlimited
+  uint32_t rejected; ///< allocations refused at the hard limit
+  uint32_t evicted;  ///< objects released to get under the soft limit
+} oc_mem_usage_t;
+
+/**
+  @brief Callback invoked from oc_main_poll() while a subsystem is above its
+  soft limit, after the stack has evicted what it could.
+
+  @param subsystem the subsystem over its soft limit
+  @param usage current accounting of the subsystem
+*/
+typedef void (*oc_mem_pressure_cb_t)(oc_mem_subsystem_t subsystem,
+                                     const oc_mem_usage_t *usage);
+
+#ifdef OC_MEMORY_BUDGET
+/* Releases one object of a subsystem; returns false if there was none. */
+typedef bool (*oc_mem_evict_cb_t)(void);
+
+void oc_mem_budget_set_evictor(oc_mem_subsystem_t subsystem,
+                               oc_mem_evict_cb_t evict);
+bool oc_mem_budget_charge(oc_mem_subsystem_t subsystem, size_t size);
+void oc_mem_budget_force_charge(oc_mem_subsystem_t subsystem, size_t size);
+void oc_mem_budget_release(oc_mem_subsystem_t subsystem, size_t size);
+bool oc_mem_budget_exhausted(void);
+void oc_mem_budget_evict(void);
+
+#define OC_MEM_CHARGE(subsystem, size) oc_mem_budget_charge((subsystem), (size))
+#define OC_MEM_FORCE_CHARGE(subsystem, size)                                   \
+  oc_mem_budget_force_charge((subsystem), (size))
+#define OC_MEM_RELEASE(subsystem, size)                                        \
+  oc_mem_budget_release((subsystem), (size))
+#else /* OC_MEMORY_BUDGET */
+#define OC_MEM_CHARGE(subsystem, size) (true)
+#define OC_MEM_FORCE_CHARGE(subsystem, size)
+#define OC_MEM_RELEASE(subsystem, size)
+#endif /* !OC_MEMORY_BUDGET */
+
+/**
+  @brief Set the limits of a subsystem. Lowering a soft limit below the
+  current usage schedules eviction on the next oc_main_poll().
+
+  @param subsystem the subsystem
+  @param soft_limit bytes above which eviction runs, 0 for no limit
+  @param hard_limit bytes above which allocations fail, 0 for no limit;
+  ignored for OC_MEM_STRINGS
+
+  @return 0 on success, -1 if the subsystem is invalid or the soft limit is
+  above a non-zero hard limit
+*/
+int oc_mem_budget_set_limits(oc_mem_subsystem_t subsystem, size_t soft_limit,
+                             size_t hard_limit);
+
+/**
+  @brief Copy the current accounting of a subsystem.
+
+  @param subsystem the subsystem
+  @param out destination (cannot be NULL)
+
+  @return 0 on success, -1 if the subsystem is invalid
+*/
+int oc_mem_budget_get_usage(oc_mem_subsystem_t subsystem,
+                            oc_mem_usage_t *out);
+
+/**
+  @brief Return the name of a subsystem, e.g. "messages".
+*/
+const char *oc_mem_budget_subsystem_name(oc_mem_subsystem_t subsystem);
+
+/** Restart peak tracking from the current usage and zero the rejected and
+ * evicted counters. */
+void oc_mem_budget_reset_peaks(void);
+
+/**
+  @brief Set the callback notified while a subsystem stays above its soft
+  limit, for instance to release application caches.
+
+  @param cb the callback, or NULL
+*/
+void oc_mem_budget_set_pressure_cb(oc_mem_pressure_cb_t cb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OC_MEM_BUDGET_H */
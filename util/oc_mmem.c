@@ -35,6 +35,7 @@
 #include "oc_mmem.h"
 #include "oc_config.h"
 #include "oc_list.h"
+#include "oc_mem_budget.h"
 #include "port/oc_log.h"
 #include <stdint.h>
 #include <string.h>
@@ -132,6 +133,11 @@ _oc_mmem_alloc(
 #ifdef OC_MEMORY_TRACE
   oc_mem_trace_add_pace(func, bytes_allocated, MEM_TRACE_ALLOC, m->ptr);
 #endif
+#ifdef OC_MEMORY_BUDGET
+  if (m->ptr) {
+    oc_mem_budget_force_charge(OC_MEM_STRINGS, bytes_allocated);
+  }
+#endif /* OC_MEMORY_BUDGET */
 
   return (int) bytes_allocated;
 }
@@ -148,7 +154,7 @@ _oc_mmem_free(
     return;
   }
 
-#ifdef OC_MEMORY_TRACE
+#if defined(OC_MEMORY_TRACE) || defined(OC_MEMORY_BUDGET)
   unsigned int bytes_freed = m->size;
   switch (pool_type) {
   case INT_POOL:
@@ -160,8 +166,15 @@ _oc_mmem_free(
   default:
     break;
   }
+#ifdef OC_MEMORY_TRACE
   oc_mem_trace_add_pace(func, bytes_freed, MEM_TRACE_FREE, m->ptr);
 #endif /* OC_MEMORY_TRACE */
+#ifdef OC_MEMORY_BUDGET
+  if (m->ptr) {
+    oc_mem_budget_release(OC_MEM_STRINGS, bytes_freed);
+  }
+#endif /* OC_MEMORY_BUDGET */
+#endif /* OC_MEMORY_TRACE || OC_MEMORY_BUDGET */
 
 #ifndef OC_DYNAMIC_ALLOCATION
   struct oc_mmem *n;
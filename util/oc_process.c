@@ -59,19 +59,36 @@ struct event_data
   struct oc_process *p;
 };
 
-#ifdef OC_DYNAMIC_ALLOCATION
-static unsigned long OC_PROCESS_NUMEVENTS = 10;
-#else /* OC_DYNAMIC_ALLOCATION */
 #define OC_PROCESS_NUMEVENTS 10
-#endif /* !OC_DYNAMIC_ALLOCATION */
 
-static oc_process_num_events_t nevents, fevent;
+/*
+ * One FIFO ring per priority level. Events are always taken from the
+ * highest priority non-empty ring, except that after OC_PROCESS_PRIO_BURST
+ * consecutive events were taken ahead of waiting lower priority events, one
+ * event is taken from the lowest priority non-empty ring so that bulk work
+ * cannot starve housekeeping forever.
+ */
+struct event_queue
+{
 #ifdef OC_DYNAMIC_ALLOCATION
-static struct event_data *events;
+  struct event_data *events;
+  oc_process_num_events_t size;
 #else  /* OC_DYNAMIC_ALLOCATION */
-static struct event_data events[OC_PROCESS_NUMEVENTS];
+  struct event_data events[OC_PROCESS_NUMEVENTS];
+#endif /* !OC_DYNAMIC_ALLOCATION */
+  oc_process_num_events_t nevents, fevent;
+};
+
+#ifdef OC_DYNAMIC_ALLOCATION
+#define QUEUE_SIZE(q) ((q)->size)
+#else /* OC_DYNAMIC_ALLOCATION */
+#define QUEUE_SIZE(q) (OC_PROCESS_NUMEVENTS)
 #endif /* !OC_DYNAMIC_ALLOCATION */
 
+static struct event_queue queues[OC_PROCESS_NUM_PRIOS];
+static oc_process_num_events_t nevents;
+static unsigned int burst;
+
 #if OC_PROCESS_CONF_STATS
 oc_process_num_events_t process_maxevents;
 #endif
@@ -194,24 +211,34 @@ void
 oc_process_shutdown(void)
 {
 #ifdef OC_DYNAMIC_ALLOCATION
-  free(events);
+  int i;
+  for (i = 0; i < OC_PROCESS_NUM_PRIOS; i++) {
+    free(queues[i].events);
+    queues[i].events = NULL;
+  }
 #endif /* OC_DYNAMIC_ALLOCATION */
 }
 
 void
 oc_process_init(void)
 {
+  int i;
+  for (i = 0; i < OC_PROCESS_NUM_PRIOS; i++) {
 #ifdef OC_DYNAMIC_ALLOCATION
-  events = (struct event_data *)calloc(OC_PROCESS_NUMEVENTS,
-                                       sizeof(struct event_data));
-  if (!events) {
-    oc_abort("Insufficient memory");
-  }
+    queues[i].size = OC_PROCESS_NUMEVENTS;
+    queues[i].events = (struct event_data *)calloc(OC_PROCESS_NUMEVENTS,
+                                                   sizeof(struct event_data));
+    if (!queues[i].events) {
+      oc_abort("Insufficient memory");
+    }
 #endif /* OC_DYNAMIC_ALLOCATION */
+    queues[i].nevents = queues[i].fevent = 0;
+  }
 
   lastevent = OC_PROCESS_EVENT_MAX;
 
-  nevents = fevent = 0;
+  nevents = 0;
+  burst = 0;
 #if OC_PROCESS_CONF_STATS
   process_maxevents = 0;
 #endif /* OC_PROCESS_CONF_STATS */
@@ -239,6 +266,37 @@ do_poll(void)
   }
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * Pick the queue to take the next event from.
+ */
+/*---------------------------------------------------------------------------*/
+static struct event_queue *
+next_queue(void)
+{
+  int prio, lowest = -1, highest = -1;
+
+  for (prio = 0; prio < OC_PROCESS_NUM_PRIOS; prio++) {
+    if (queues[prio].nevents > 0) {
+      if (highest < 0) {
+        highest = prio;
+      }
+      lowest = prio;
+    }
+  }
+  if (highest < 0) {
+    return NULL;
+  }
+  if (lowest == highest) {
+    burst = 0;
+    return &queues[highest];
+  }
+  if (++burst > OC_PROCESS_PRIO_BURST) {
+    burst = 0;
+    return &queues[lowest];
+  }
+  return &queues[highest];
+}
+/*---------------------------------------------------------------------------*/
 /*
  * Process the next event in the event queue and deliver it to
  * listening processes.
@@ -251,6 +309,7 @@ do_event(void)
   static oc_process_data_t data;
   static struct oc_process *receiver;
   static struct oc_process *p;
+  struct event_queue *q = next_queue();
 
   /*
    * If there are any events in the queue, take the first one and walk
@@ -260,17 +319,18 @@ do_event(void)
    * call the poll handlers inbetween.
    */
 
-  if (nevents > 0) {
+  if (q) {
 
     /* There are events that we should deliver. */
-    ev = events[fevent].ev;
+    ev = q->events[q->fevent].ev;
 
-    data = events[fevent].data;
-    receiver = events[fevent].p;
+    data = q->events[q->fevent].data;
+    receiver = q->events[q->fevent].p;
 
     /* Since we have seen the new event, we move pointer upwards
        and decrease the number of events. */
-    fevent = (fevent + 1) % OC_PROCESS_NUMEVENTS;
+    q->fevent = (q->fevent + 1) % QUEUE_SIZE(q);
+    --q->nevents;
     --nevents;
 
     /* If this is a broadcast event, we deliver it to all events, in
@@ -303,13 +363,21 @@ do_event(void)
 int
 oc_process_run(void)
 {
-  /* Process poll events. */
-  if (poll_requested) {
-    do_poll();
-  }
+  return oc_process_run_n(1);
+}
+/*---------------------------------------------------------------------------*/
+int
+oc_process_run_n(int max_events)
+{
+  do {
+    /* Process poll events. */
+    if (poll_requested) {
+      do_poll();
+    }
 
-  /* Process one event from the queue */
-  do_event();
+    /* Process one event from the queue */
+    do_event();
+  } while (--max_events > 0 && nevents > 0);
 
   return nevents + poll_requested;
 }
@@ -323,37 +391,49 @@ oc_process_nevents(void)
 int
 oc_process_post(struct oc_process *p, oc_process_event_t ev,
                 oc_process_data_t data)
+{
+  return oc_process_post_prio(p, ev, data, OC_PROCESS_PRIO_NORMAL);
+}
+/*---------------------------------------------------------------------------*/
+int
+oc_process_post_prio(struct oc_process *p, oc_process_event_t ev,
+                     oc_process_data_t data, oc_process_prio_t prio)
 {
   static oc_process_num_events_t snum;
+  struct event_queue *q;
 
-  if (nevents == OC_PROCESS_NUMEVENTS) {
+  if ((int)prio < 0 || prio >= OC_PROCESS_NUM_PRIOS) {
+    prio = OC_PROCESS_PRIO_NORMAL;
+  }
+  q = &queues[prio];
+
+  if (q->nevents == QUEUE_SIZE(q)) {
 #ifdef OC_DYNAMIC_ALLOCATION
-    OC_PROCESS_NUMEVENTS <<= 1;
-    events = (struct event_data *)realloc(events, (OC_PROCESS_NUMEVENTS) *
-                                                    sizeof(struct event_data));
+    /* Grow the ring and unwrap it so that the oldest event is at index 0. */
+    oc_process_num_events_t i, size = q->size << 1;
+    struct event_data *events =
+      (struct event_data *)calloc(size, sizeof(struct event_data));
     if (!events) {
       oc_abort("Insufficient memory");
     }
-    oc_process_num_events_t i = fevent, n = nevents - fevent, j = 0;
-    while (i < (OC_PROCESS_NUMEVENTS - n)) {
-      if (i < nevents) {
-        memcpy(&events[OC_PROCESS_NUMEVENTS - n + j], &events[i],
-               sizeof(struct event_data));
-        j++;
-      }
-      memset(&events[i], 0, sizeof(struct event_data));
-      i++;
+    for (i = 0; i < q->nevents; i++) {
+      memcpy(&events[i], &q->events[(q->fevent + i) % q->size],
+             sizeof(struct event_data));
     }
-    fevent = OC_PROCESS_NUMEVENTS - n;
+    free(q->events);
+    q->events = events;
+    q->size = size;
+    q->fevent = 0;
 #else  /* OC_DYNAMIC_ALLOCATION */
     return OC_PROCESS_ERR_FULL;
 #endif /* !OC_DYNAMIC_ALLOCATION */
   }
 
-  snum = (oc_process_num_events_t)(fevent + nevents) % OC_PROCESS_NUMEVENTS;
-  events[snum].ev = ev;
-  events[snum].data = data;
-  events[snum].p = p;
+  snum = (oc_process_num_events_t)(q->fevent + q->nevents) % QUEUE_SIZE(q);
+  q->events[snum].ev = ev;
+  q->events[snum].data = data;
+  q->events[snum].p = p;
+  ++q->nevents;
   ++nevents;
 
 #if OC_PROCESS_CONF_STATS
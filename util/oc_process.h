@@ -83,6 +83,33 @@ typedef unsigned char oc_process_num_events_t;
 #define OC_PROCESS_ERR_FULL 1
 /* @} */
 
+/**
+ * \brief      Event priorities.
+ *
+ *             Pending events are kept in one queue per priority and are
+ *             delivered from the highest priority queue that is not
+ *             empty. Events of equal priority are delivered in the order
+ *             they were posted.
+ */
+typedef enum {
+  OC_PROCESS_PRIO_HIGH = 0,  ///< CoAP ACK/RST and outbound messages
+  OC_PROCESS_PRIO_HANDSHAKE, ///< (D)TLS handshake records
+  OC_PROCESS_PRIO_NORMAL,    ///< requests, responses and timers (default)
+  OC_PROCESS_PRIO_LOW,       ///< housekeeping
+  OC_PROCESS_NUM_PRIOS
+} oc_process_prio_t;
+
+/**
+ * \brief      Starvation bound for lower priority events.
+ *
+ *             After this many consecutive events were delivered while
+ *             lower priority events were waiting, one event from the
+ *             lowest priority non-empty queue is delivered next.
+ */
+#ifndef OC_PROCESS_PRIO_BURST
+#define OC_PROCESS_PRIO_BURST (32)
+#endif /* !OC_PROCESS_PRIO_BURST */
+
 #define OC_PROCESS_NONE NULL
 
 #define OC_PROCESS_EVENT_NONE 0x80
@@ -367,6 +394,30 @@ void oc_process_start(struct oc_process *p, oc_process_data_t data);
 int oc_process_post(struct oc_process *p, oc_process_event_t ev,
                     oc_process_data_t data);
 
+/**
+ * Post an asynchronous event with a priority.
+ *
+ * Same as oc_process_post(), which posts with OC_PROCESS_PRIO_NORMAL, but
+ * the event is queued at the given priority. Events posted at different
+ * priorities may be delivered in a different order than they were posted.
+ *
+ * \param p The process to which the event should be posted, or
+ * OC_PROCESS_BROADCAST if the event should be posted to all processes.
+ *
+ * \param ev The event to be posted.
+ *
+ * \param data The auxiliary data to be sent with the event
+ *
+ * \param prio The priority of the event.
+ *
+ * \retval OC_PROCESS_ERR_OK The event could be posted.
+ *
+ * \retval OC_PROCESS_ERR_FULL The event queue for this priority was full
+ * and the event could not be posted.
+ */
+int oc_process_post_prio(struct oc_process *p, oc_process_event_t ev,
+                         oc_process_data_t data, oc_process_prio_t prio);
+
 /**
  * Post a synchronous event to a process.
  *
@@ -506,6 +557,20 @@ void oc_process_shutdown(void);
  */
 int oc_process_run(void);
 
+/**
+ * Run the system for up to max_events events.
+ *
+ * Like oc_process_run(), but delivers up to max_events events, calling
+ * the poll handlers that were requested in between, before returning.
+ * Returns early when the event queue becomes empty.
+ *
+ * \param max_events The maximum number of events to deliver.
+ *
+ * \return The number of events that are currently waiting in the
+ * event queue.
+ */
+int oc_process_run_n(int max_events);
+
 /**
  * Check if a process is running.
  *